@@ -5,6 +5,8 @@
  * Sine waveform output from 7,421 mHz to 7812.5 Hz
  * Triangle from 3.725 mHz to 1953.125 Hz
  * Sawtooth from 1.866 mHz to 3906.25 Hz
+ * Pulse from 238 mHz to 8 MHz with pulse width from 62.5 ns to period - 62.5 ns
+ * DC from 0 to VCC, closed loop controlled by reading back the RC filter output at DC_SOURCE_FEEDBACK_CHANNEL
  *
  * !!!Do not run DSO acquisition and non square wave waveform generation at the same time!!!
  * Because of the interrupts at 62 kHz rate, DSO is almost not usable during non square wave waveform generation.
@@ -75,6 +77,10 @@ static void (*sLastRedrawCallback)(void);
 #define FREQ_SLIDER_X 5
 #define FREQ_SLIDER_Y (4 * TEXT_SIZE_11_HEIGHT + 4)
 
+// Pulse width, PWM resolution and DC voltage button share this position
+#define PULSE_WIDTH_BUTTON_Y (FREQ_SLIDER_Y + 3 * FREQ_SLIDER_SIZE + 2) // between slider labels and fixed frequency buttons
+#define PULSE_WIDTH_BUTTON_HEIGHT (2 * TEXT_SIZE_11_HEIGHT)
+
 /*
  * Direct frequency + range buttons
  */
@@ -100,6 +106,42 @@ struct FrequencyInfoStruct sFrequencyInfo;
 #define INDEX_OF_10HZ 2
 static bool is10HzRange = true;
 
+#ifdef AVR
+/*
+ * Closed loop control for WAVEFORM_DC
+ * Connect output of RC filter at pin 10 to DC_SOURCE_FEEDBACK_CHANNEL.
+ * The ADC is owned by the DSO acquisition and the data logger while they are running,
+ * so the feedback is only read in analyze mode. During acquisition the last PWM value is kept.
+ * It is kept too, if the DSO channel uses the 1.1 volt reference, since AREF needs 4 ms to settle back after reading with VCC,
+ * or the internal 1.1 volt channel, since it needs 400 us to settle after switching back.
+ * The feedback is read with one conversion per main loop, so each call blocks only for around 110 us.
+ */
+#define DC_SOURCE_FEEDBACK_CHANNEL 4 // A4
+#define DC_SOURCE_MILLIVOLT_DEFAULT 2500
+#define DC_SOURCE_LOOP_MILLIS 20 // >> time constant of 2k2 Ohm and 100 nF filter
+#define DC_SOURCE_DISPLAY_LOOPS 25 // print measured value every 500 ms
+#define DC_SOURCE_OVERSAMPLE_EXPONENT 4 // average 16 samples to suppress PWM ripple - one sample per main loop
+/*
+ * PWM and ADC both have 10 bit and VCC as reference, so setpoint in ADC counts is used as feed forward PWM value.
+ * PI controller only corrects for load and offset. Gains are powers of 2 to avoid multiplication.
+ */
+#define DC_SOURCE_KP_SHIFT 1 // Kp = 1/2
+#define DC_SOURCE_KI_SHIFT 2 // Ki = 1/4 per loop
+#define DC_SOURCE_INTEGRAL_MAX ((int16_t) DC_PWM_TOP << DC_SOURCE_KI_SHIFT) // anti windup
+
+struct DCSourceControlStruct {
+    uint16_t SetpointMillivolt;
+    uint16_t MeasuredMillivolt;
+    bool isMeasured; // false if acquisition is running and PWM value is kept
+    uint8_t SampleCount; // samples of the running feedback measurement, 0 -> no measurement running
+    uint16_t SampleSum;
+    int16_t Integral; // sum of errors in ADC counts
+    uint32_t MillisOfLastLoop;
+    uint8_t LoopCount; // for display
+};
+static DCSourceControlStruct DCSourceControl;
+#endif
+
 
 static const int BUTTON_INDEX_SELECTED_INITIAL = 2; // select 10Hz Button
 
@@ -112,6 +154,11 @@ BDButton ActiveTouchButtonFrequencyRange; // Used to determine which range butto
 BDButton TouchButtonFrequencyStartStop;
 BDButton TouchButtonGetFrequency;
 BDButton TouchButtonWaveform;
+#ifdef AVR
+BDButton TouchButtonPulseWidth;
+BDButton TouchButtonPWMResolution;
+BDButton TouchButtonDCVoltage;
+#endif
 
 #ifdef LOCAL_DISPLAY_EXISTS
 BDButton TouchButton1;
@@ -146,7 +193,14 @@ bool setWaveformFrequencyAndPrintValues();
 
 void printFrequencyAndPeriod();
 #ifdef AVR
+BDButton * getWaveformOptionButton(void);
 void setWaveformButtonCaption(void);
+void setPulseWidthButtonCaption(void);
+void doGetPulseWidth(BDButton * aTheTouchedButton, int16_t aValue);
+void setPWMResolutionButtonCaption(void);
+void doPWMResolution(BDButton * aTheTouchedButton, int16_t aValue);
+void doGetDCVoltage(BDButton * aTheTouchedButton, int16_t aValue);
+void printDCSourceValues(void);
 void initTimer1ForCTC(void);
 #else
 #endif
@@ -170,6 +224,10 @@ void initFrequencyGeneratorPage(void) {
      */
     sFrequencyInfo.isOutputEnabled = false;
     sFrequencyInfo.Waveform = WAVEFORM_SQUARE;
+#ifdef AVR
+    sFrequencyInfo.PulseWidthClocks = PULSE_WIDTH_MICROS_DEFAULT * clockCyclesPerMicrosecond();
+    DCSourceControl.SetpointMillivolt = DC_SOURCE_MILLIVOLT_DEFAULT;
+#endif
     setWaveformFrequency(200);
 
     sFrequencyInfo.isOutputEnabled = true; // to start output at first display of page
@@ -295,6 +353,17 @@ void initFrequencyGeneratorPageGui() {
     TouchButtonWaveform.init(BUTTON_WIDTH_3_POS_3, REMOTE_DISPLAY_HEIGHT - BUTTON_HEIGHT_4, BUTTON_WIDTH_3,
             BUTTON_HEIGHT_4, COLOR_BLUE, "", TEXT_SIZE_18, FLAG_BUTTON_DO_BEEP_ON_TOUCH, sFrequencyInfo.Waveform, &doWaveformMode);
     setWaveformButtonCaption();
+
+    // Only visible in pulse mode, caption shows the achieved pulse width
+    TouchButtonPulseWidth.init(BUTTON_WIDTH_3_POS_2, PULSE_WIDTH_BUTTON_Y, BUTTON_WIDTH_3, PULSE_WIDTH_BUTTON_HEIGHT, COLOR_BLUE, "",
+    TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doGetPulseWidth);
+    // Only visible for sine, triangle, sawtooth and noise
+    TouchButtonPWMResolution.init(BUTTON_WIDTH_3_POS_2, PULSE_WIDTH_BUTTON_Y, BUTTON_WIDTH_3, PULSE_WIDTH_BUTTON_HEIGHT, COLOR_BLUE,
+            "", TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doPWMResolution);
+    setPWMResolutionButtonCaption();
+    // Only visible in DC mode
+    TouchButtonDCVoltage.init(BUTTON_WIDTH_3_POS_2, PULSE_WIDTH_BUTTON_Y, BUTTON_WIDTH_3, PULSE_WIDTH_BUTTON_HEIGHT, COLOR_BLUE,
+            F("Volt..."), TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doGetDCVoltage);
 #endif
 }
 
@@ -351,6 +420,13 @@ void drawFrequencyGeneratorPage(void) {
     TouchButtonFrequencyStartStop.drawButton();
     TouchButtonGetFrequency.drawButton();
     TouchButtonWaveform.drawButton();
+#ifdef AVR
+    // pulse width button is drawn by printFrequencyAndPeriod()
+    BDButton * tOptionButton = getWaveformOptionButton();
+    if (tOptionButton != NULL && tOptionButton != &TouchButtonPulseWidth) {
+        tOptionButton->drawButton();
+    }
+#endif
 
     // show values
     printFrequencyAndPeriod();
@@ -390,15 +466,71 @@ void doFrequencySlider(BDSlider * aTheTouchedSlider, uint16_t aValue) {
  * Button handlers
  */
 #ifdef AVR
+/*
+ * Returns the button shown at PULSE_WIDTH_BUTTON_Y for the current waveform or NULL
+ */
+BDButton * getWaveformOptionButton(void) {
+    if (sFrequencyInfo.Waveform == WAVEFORM_PULSE) {
+        return &TouchButtonPulseWidth;
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_DC) {
+        return &TouchButtonDCVoltage;
+    } else if (isPWMWaveform()) {
+        return &TouchButtonPWMResolution;
+    }
+    return NULL;
+}
+
 void setWaveformButtonCaption(void) {
     TouchButtonWaveform.setCaptionPGM(getWaveformModePGMString(), (DisplayControl.DisplayPage == DISPLAY_PAGE_FREQUENCY));
 }
+
+/*
+ * Shows achieved pulse width as caption and draws button
+ */
+void setPulseWidthButtonCaption(void) {
+    dtostrf(getPulseWidthMicros(), 1, 3, &sStringBuffer[20]);
+    sprintf_P(sStringBuffer, PSTR("%s\xB5s"), &sStringBuffer[20]);
+    TouchButtonPulseWidth.setCaption(sStringBuffer, (DisplayControl.DisplayPage == DISPLAY_PAGE_FREQUENCY));
+}
+
+void setPWMResolutionButtonCaption(void) {
+    sprintf_P(sStringBuffer, PSTR("%u bit PWM"), getPWMResolutionBits());
+    TouchButtonPWMResolution.setCaption(sStringBuffer, (DisplayControl.DisplayPage == DISPLAY_PAGE_FREQUENCY && isPWMWaveform()));
+}
+
+/*
+ * Cycles 8, 9 and 10 bit PWM resolution
+ */
+void doPWMResolution(BDButton * aTheTouchedButton, int16_t aValue) {
+    cyclePWMResolution();
+    setPWMResolutionButtonCaption();
+    // maximum frequency depends on resolution
+    printFrequencyAndPeriod();
+}
 #endif
 
 void doWaveformMode(BDButton * aTheTouchedButton, int16_t aValue) {
 #ifdef AVR
+    BDButton * tOldOptionButton = getWaveformOptionButton();
     cycleWaveformMode();
+    if (sFrequencyInfo.Waveform == WAVEFORM_DC) {
+        DCSourceControl.Integral = 0;
+        DCSourceControl.SampleCount = 0; // discard samples of an interrupted feedback measurement
+    }
     setWaveformButtonCaption();
+    BDButton * tNewOptionButton = getWaveformOptionButton();
+    if (tOldOptionButton != tNewOptionButton) {
+        if (tOldOptionButton != NULL) {
+            tOldOptionButton->removeButton(COLOR_BACKGROUND_FREQ);
+        }
+        if (tNewOptionButton != NULL && tNewOptionButton != &TouchButtonPulseWidth) {
+            tNewOptionButton->drawButton();
+        }
+    }
+    if (sFrequencyInfo.Waveform == WAVEFORM_PULSE || sFrequencyInfo.Waveform == WAVEFORM_DC
+            || tOldOptionButton == &TouchButtonDCVoltage) {
+        printFrequencyAndPeriod(); // draws pulse width button and switches between frequency and DC values
+    }
 #endif
 }
 
@@ -433,7 +565,8 @@ void doSetFrequencyRange(BDButton * aTheTouchedButton, int16_t aValue) {
         }
 
         // No MHz for PWM waveforms
-        if (aValue != FREQUENCY_FACTOR_INDEX_MEGA_HERTZ || sFrequencyInfo.Waveform == WAVEFORM_SQUARE) {
+        if (aValue != FREQUENCY_FACTOR_INDEX_MEGA_HERTZ || sFrequencyInfo.Waveform == WAVEFORM_SQUARE
+                || sFrequencyInfo.Waveform == WAVEFORM_PULSE) {
 
             ActiveTouchButtonFrequencyRange.setButtonColorAndDraw( BUTTON_AUTO_RED_GREEN_FALSE_COLOR);
             ActiveTouchButtonFrequencyRange = *aTheTouchedButton;
@@ -479,9 +612,160 @@ void doGetFrequency(BDButton * aTheTouchedButton, int16_t aValue) {
 }
 #endif
 
+#ifdef AVR
+/**
+ * Handler for number receive event - set pulse width to float value
+ */
+void doSetPulseWidth(float aValue) {
+    bool tErrorOrClippingHappend = setPulseWidthMicros(aValue);
+    printFrequencyAndPeriod();
+    BlueDisplay1.playFeedbackTone(tErrorOrClippingHappend);
+}
+
+/**
+ * Request pulse width numerical
+ */
+void doGetPulseWidth(BDButton * aTheTouchedButton, int16_t aValue) {
+    BlueDisplay1.getNumberWithShortPrompt(&doSetPulseWidth, F("pulse width [us]"), getPulseWidthMicros());
+}
+
+/**
+ * Handler for number receive event - set DC voltage to float value, clipped to 0 to VCC
+ */
+void doSetDCVoltage(float aValue) {
+    bool tErrorOrClippingHappend = false;
+    if (aValue < 0) {
+        aValue = 0;
+        tErrorOrClippingHappend = true;
+    } else if (aValue > MeasurementControl.VCC) {
+        aValue = MeasurementControl.VCC;
+        tErrorOrClippingHappend = true;
+    }
+    DCSourceControl.SetpointMillivolt = aValue * 1000;
+    DCSourceControl.Integral = 0; // sum of errors of old setpoint is meaningless for the new one
+    printDCSourceValues();
+    BlueDisplay1.playFeedbackTone(tErrorOrClippingHappend);
+}
+
+/**
+ * Request DC voltage numerical
+ */
+void doGetDCVoltage(BDButton * aTheTouchedButton, int16_t aValue) {
+    BlueDisplay1.getNumberWithShortPrompt(&doSetDCVoltage, F("DC voltage [V]"), DCSourceControl.SetpointMillivolt / 1000.0);
+}
+
+/*
+ * Prints setpoint and measured voltage at the position of frequency and period
+ */
+void printDCSourceValues(void) {
+    dtostrf(DCSourceControl.SetpointMillivolt / 1000.0, 9, 3, &sStringBuffer[20]);
+    sprintf_P(sStringBuffer, PSTR("%s V "), &sStringBuffer[20]);
+    BlueDisplay1.drawText(FREQ_SLIDER_X + 2 * TEXT_SIZE_22_WIDTH, TEXT_SIZE_22_HEIGHT, sStringBuffer, TEXT_SIZE_22,
+    COLOR_RED, COLOR_BACKGROUND_FREQ);
+
+    if (DCSourceControl.isMeasured) {
+        dtostrf(DCSourceControl.MeasuredMillivolt / 1000.0, 10, 3, &sStringBuffer[20]);
+        sprintf_P(sStringBuffer, PSTR("%s V"), &sStringBuffer[20]);
+    } else {
+        // no feedback available while acquisition or logger is running or 1.1 volt reference or channel is used
+        strcpy_P(sStringBuffer, PSTR("      hold  "));
+    }
+    BlueDisplay1.drawText(FREQ_SLIDER_X, TEXT_SIZE_22_HEIGHT + 4 + TEXT_SIZE_22_ASCEND, sStringBuffer, TEXT_SIZE_22,
+    COLOR_BLUE, COLOR_BACKGROUND_FREQ);
+}
+
+/*
+ * Called by main loop. One PI control step every DC_SOURCE_LOOP_MILLIS, if DC waveform is active.
+ * Runs independently of the displayed page, so the voltage is kept while the DSO is shown.
+ * The feedback samples for one step are read by the following calls, one conversion per call.
+ */
+void loopDCSource(void) {
+    if (sFrequencyInfo.Waveform != WAVEFORM_DC || !sFrequencyInfo.isOutputEnabled) {
+        return;
+    }
+
+    bool tADCIsBusy = MeasurementControl.isRunning;
+#ifdef SUPPORT_DATA_LOGGER
+    tADCIsBusy = tADCIsBusy || DataLogger.isRunning;
+#endif
+    // ADC is used by acquisition ISR or switching the reference would change AREF for next acquisition, keep last PWM value
+    tADCIsBusy = tADCIsBusy || MeasurementControl.ADCReference != DEFAULT || (ADMUX & 0x0F) == ADC_1_1_VOLT_CHANNEL;
+
+    if (DCSourceControl.SampleCount == 0) {
+        if (millis() - DCSourceControl.MillisOfLastLoop < DC_SOURCE_LOOP_MILLIS) {
+            return;
+        }
+        DCSourceControl.MillisOfLastLoop = millis();
+
+        DCSourceControl.LoopCount++;
+        if (DCSourceControl.LoopCount >= DC_SOURCE_DISPLAY_LOOPS) {
+            DCSourceControl.LoopCount = 0;
+            if (DisplayControl.DisplayPage == DISPLAY_PAGE_FREQUENCY) {
+                printDCSourceValues();
+            }
+        }
+        DCSourceControl.SampleSum = 0;
+    }
+
+    if (tADCIsBusy) {
+        // abort running feedback measurement
+        DCSourceControl.SampleCount = 0;
+        DCSourceControl.isMeasured = false;
+        return;
+    }
+
+    /*
+     * Read one feedback sample with VCC as reference and restore ADC settings for next acquisition.
+     * Reference is not switched here, only the channel. Single conversion takes 104 us with ADC_PRESCALE128.
+     */
+    uint8_t tOldADMUX = ADMUX;
+    ADMUX = DC_SOURCE_FEEDBACK_CHANNEL | (DEFAULT << REFS0);
+    // single conversion without auto trigger, like readADCChannelWithReferenceOversample() leaves the ADC
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADIF) | ADC_PRESCALE128;
+    loop_until_bit_is_clear(ADCSRA, ADSC);
+    uint8_t tLowByte = ADCL; // ADCL must be read first
+    DCSourceControl.SampleSum += (ADCH << 8) | tLowByte;
+    ADMUX = tOldADMUX;
+
+    DCSourceControl.SampleCount++;
+    if (DCSourceControl.SampleCount < _BV(DC_SOURCE_OVERSAMPLE_EXPONENT)) {
+        return;
+    }
+    DCSourceControl.SampleCount = 0;
+
+    uint16_t tVCCMillivolt = MeasurementControl.VCC * 1000;
+    uint16_t tMeasuredValue = DCSourceControl.SampleSum >> DC_SOURCE_OVERSAMPLE_EXPONENT;
+
+    int16_t tSetpointValue = ((uint32_t) DCSourceControl.SetpointMillivolt * DC_PWM_TOP) / tVCCMillivolt;
+    int16_t tError = tSetpointValue - (int16_t) tMeasuredValue;
+    int16_t tIntegral = DCSourceControl.Integral + tError;
+    if (tIntegral > DC_SOURCE_INTEGRAL_MAX) {
+        tIntegral = DC_SOURCE_INTEGRAL_MAX;
+    } else if (tIntegral < -DC_SOURCE_INTEGRAL_MAX) {
+        tIntegral = -DC_SOURCE_INTEGRAL_MAX;
+    }
+    DCSourceControl.Integral = tIntegral;
+
+    int16_t tPWMValue = tSetpointValue + (tError >> DC_SOURCE_KP_SHIFT) + (tIntegral >> DC_SOURCE_KI_SHIFT);
+    if (tPWMValue > DC_PWM_TOP) {
+        tPWMValue = DC_PWM_TOP;
+    } else if (tPWMValue < 0) {
+        tPWMValue = 0;
+    }
+    setDCPWMValue(tPWMValue);
+
+    DCSourceControl.MeasuredMillivolt = ((uint32_t) tMeasuredValue * tVCCMillivolt) / DC_PWM_TOP;
+    DCSourceControl.isMeasured = true;
+}
+#endif
+
 void doFrequencyGeneratorStartStop(BDButton * aTheTouchedButton, int16_t aValue) {
     sFrequencyInfo.isOutputEnabled = aValue;
     if (aValue) {
+#ifdef AVR
+        // DC output starts with feed forward value only
+        DCSourceControl.Integral = 0;
+#endif
         // Start timer
 #ifndef AVR
         Synth_Timer_Start();
@@ -505,6 +789,11 @@ void printFrequencyAndPeriod() {
     float tPeriodMicros;
 
 #ifdef AVR
+    if (sFrequencyInfo.Waveform == WAVEFORM_DC) {
+        // frequency is meaningless here
+        printDCSourceValues();
+        return;
+    }
     dtostrf(sFrequencyInfo.FrequencyNormalized, 9, 3, &sStringBuffer[20]);
     sprintf_P(sStringBuffer, PSTR("%s%cHz"), &sStringBuffer[20], FrequencyFactorChars[sFrequencyInfo.FrequencyFactorIndex]);
 
@@ -535,6 +824,13 @@ void printFrequencyAndPeriod() {
     BlueDisplay1.drawText(FREQ_SLIDER_X, TEXT_SIZE_22_HEIGHT + 4 + TEXT_SIZE_22_ASCEND, sStringBuffer, TEXT_SIZE_22,
     COLOR_BLUE, COLOR_BACKGROUND_FREQ);
 
+#ifdef AVR
+    if (sFrequencyInfo.Waveform == WAVEFORM_PULSE) {
+        // achieved pulse width depends on prescaler of period
+        setPulseWidthButtonCaption();
+    }
+#endif
+
 // 950 byte program space needed for pow() and log10f()
     uint16_t tSliderValue;
     tSliderValue = log10f(sFrequencyInfo.FrequencyNormalized) * (FREQ_SLIDER_MAX_VALUE / 3);
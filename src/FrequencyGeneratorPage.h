@@ -23,6 +23,7 @@ void drawFrequencyGeneratorPage(void);
 void startFrequencyGeneratorPage(void);
 void loopFrequencyGeneratorPage(void);
 void stopFrequencyGeneratorPage(void);
+void loopDCSource(void);
 
 //extern BDButton TouchButtonFrequencyPage;
 
@@ -0,0 +1,74 @@
+/*
+ * ISRTiming.h
+ *
+ * Histograms of latency and duration of the ADC and timer1 waveform ISRs.
+ * Activate MEASURE_ISR_TIMING to find out which ISR delays the others and causes sample overruns.
+ * The USART receive ISR of the BlueDisplay library is not measured, since this would require changes in the library.
+ * Its influence is contained in the latencies of the measured ISRs.
+ * Histograms are shown on the ISR timing page, which is opened by a long touch at the settings page.
+ *
+ *  Copyright (C) 2026  agent
+ *  Email: agent@local
+ *  License: GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ */
+
+#ifndef ISRTIMING_H_
+#define ISRTIMING_H_
+
+#include <inttypes.h>
+#include <avr/io.h>
+#include "Timer2Alias.h"
+
+//#define MEASURE_ISR_TIMING
+
+#ifdef MEASURE_ISR_TIMING
+#define ISR_TIMING_ADC 0
+#define ISR_TIMING_TIMER1_OVF 1
+#define ISR_TIMING_NUMBER_OF_ISRS 2
+
+#define ISR_TIMING_DURATION_HISTOGRAM_SIZE 8 // bin n holds durations from 2^n to 2^(n+1)-1 timer2 ticks of 4 us, bin 0 holds 0 and 1
+#define ISR_TIMING_LATENCY_HISTOGRAM_SIZE 12 // bin n holds latencies from 2^n to 2^(n+1)-1 CPU cycles, last bin holds all >= 2048
+#define ISR_TIMING_NO_LATENCY 0xFFFF // latency is unknown for this call
+
+struct ISRTimingStruct {
+    uint16_t DurationHistogram[ISR_TIMING_DURATION_HISTOGRAM_SIZE];
+    uint16_t LatencyHistogram[ISR_TIMING_LATENCY_HISTOGRAM_SIZE];
+};
+extern ISRTimingStruct ISRTiming[ISR_TIMING_NUMBER_OF_ISRS];
+
+/*
+ * Adds one call to the histograms. Must be called at the end of the ISR with the value of TCNT2 read at its start.
+ * Duration is measured with 4 us resolution and does not include register save and restore.
+ * Latency is the time from the interrupt condition to the start of the ISR body, including the register save.
+ * Always inline, since a function call from an ISR makes the compiler push and pop all 12 call used registers
+ * in the ISR prologue and epilogue, which adds about 50 cycles to each ISR call.
+ * This applies to all helpers called from ISRs, e.g. startTriggerDelayTimer() and traceEvent().
+ */
+inline void addISRTiming(uint8_t aISRIndex, uint8_t aTimer2TicksAtStart, uint16_t aLatencyCycles)
+        __attribute__((always_inline));
+void addISRTiming(uint8_t aISRIndex, uint8_t aTimer2TicksAtStart, uint16_t aLatencyCycles) {
+    ISRTimingStruct * tISRTiming = &ISRTiming[aISRIndex];
+    // timer2 wraps after 256 ticks -> longest measurable duration is 1 ms
+    uint8_t tDuration = TCNT2 - aTimer2TicksAtStart;
+    uint8_t tBin = 0;
+    while (tDuration > 1) {
+        tDuration >>= 1;
+        tBin++;
+    }
+    if (tISRTiming->DurationHistogram[tBin] != 0xFFFF) {
+        tISRTiming->DurationHistogram[tBin]++;
+    }
+    if (aLatencyCycles != ISR_TIMING_NO_LATENCY) {
+        tBin = 0;
+        while (aLatencyCycles > 1 && tBin < ISR_TIMING_LATENCY_HISTOGRAM_SIZE - 1) {
+            aLatencyCycles >>= 1;
+            tBin++;
+        }
+        if (tISRTiming->LatencyHistogram[tBin] != 0xFFFF) {
+            tISRTiming->LatencyHistogram[tBin]++;
+        }
+    }
+}
+#endif // MEASURE_ISR_TIMING
+
+#endif // ISRTIMING_H_
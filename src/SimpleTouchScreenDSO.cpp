@@ -76,7 +76,9 @@
  *                  - Reference voltage: 5=5V 1  1=1.1Volt-internal-reference.
  *                  - Number of input channel (1-5) and Temp=AVR-temperature VRef=1.1Volt-internal-reference
  *
- *      2. line: frequency, period, 1st interval, 2nd interval (, trigger delay)
+ *      2. line: frequency, period, 1st interval, 2nd interval (, trigger delay or number of lost samples)
+ *
+ *      The info is red, if samples of the acquisition were lost because the ADC ISR was delayed by other ISRs.
  *
  *      "Offset man" is currently not implemented and works like "Offset 0V".
  *
@@ -164,6 +166,9 @@
 
 #include "BlueDisplay.h"
 #include "digitalWriteFast.h"
+#include "Timer2Alias.h"
+
+#include <avr/eeprom.h>
 
 #if ! defined(USE_SIMPLE_SERIAL)
 #error "TochScreenDSO works only with USE_SIMPLE_SERIAL activated, since the serial interrupts kill the DSO timing!"
@@ -184,15 +189,6 @@ bool sBackButtonPressed;
 #define INTERNAL 3
 #endif
 
-#if !defined(TIMSK2)
-// on ATmega32U4 we have no timer2 but one timer3
-#define TIMSK2 TIMSK3
-#define TOIE2  TOIE3
-#endif
-
-#define ADC_TEMPERATURE_CHANNEL 8
-#define ADC_1_1_VOLT_CHANNEL 0x0E
-
 /*
  * Timebase values overview:                                              Polling mode
  *                            conversion                                   Fast Ultra
@@ -209,47 +205,97 @@ bool sBackButtonPressed;
  * 9   10ms    PRESCALE128  8   320    9920   102400     1    64    4   80  Draw while
  * 10  20ms    PRESCALE128  8   648   20088   207360     1    64    4  162   acquire
  * 11  50ms    PRESCALE128  8  1616   50096   517120     1   256   16  101      x
- * 12 100ms    PRESCALE128  8  3224   99944   517120     1   256   16  201.5    x
  * 12 100ms    PRESCALE128  8  3216   99696   517120     1   256   16  201      x
- * 12 100ms    PRESCALE128  8  3232  100192   517120     1   256   16  202      x
- * 13 200ms    PRESCALE128  8  6448  199888   517120     1  1024   64  100.75   x
- * 14 200ms    PRESCALE128  8  6464  200384   517120     1  1024   64  101      x
- * 15 500ms    PRESCALE128  8 16128  499968  5160960     1  1024   64  252      x
- */
-
-// for 31 grid
-const uint16_t TimebaseDivPrintValues[TIMEBASE_NUMBER_OF_ENTRIES] PROGMEM = { 10, 20, 50, 101, 201, 496, 1, 2, 5, 10, 20, 50, 100,
-        200, 500 };
-// exact values for 31 grid - for period and frequency
-const float TimebaseExactDivValuesMicros[TIMEBASE_NUMBER_OF_ENTRIES] PROGMEM
-= { 100.75/*(31*13*0,25)*/, 100.75, 100.75, 201.5, 201.5 /*(31*13*0,5)*/, 496 /*(31*16*1)*/, 992 /*(31*16*2)*/, 1984 /*(31*16*4)*/,
-        4960 /*(31*20*8)*/, 9920 /*(31*40*8)*/, 20088 /*(31*81*8)*/, 50096 /*(31*202*8)*/, 99696 /*(31*201*16)*/,
-        200384 /*(31*808*8)*/, 499968 /*(31*2016*8)*/};
-
-const uint8_t xScaleForTimebase[TIMEBASE_NUMBER_OF_XSCALE_CORRECTION] = { 10, 5, 2, 2 }; // multiply displayed values to simulate a faster timebase.
-// since prescale PRESCALE4 has bad quality use PRESCALE8 for 201 us range and display each value twice
-// All timebase >= TIMEBASE_NUMBER_OF_FAST_PRESCALE use PRESCALE128
-const uint8_t ADCPrescaleValueforTimebase[TIMEBASE_NUMBER_OF_FAST_PRESCALE] = { ADC_PRESCALE4, ADC_PRESCALE4, ADC_PRESCALE4,
-ADC_PRESCALE8, ADC_PRESCALE8, ADC_PRESCALE16 /*496us*/, ADC_PRESCALE32, ADC_PRESCALE64 /*2ms*/};
-
-const uint8_t CTCValueforTimebase[TIMEBASE_NUMBER_OF_ENTRIES - TIMEBASE_NUMBER_OF_FAST_MODES] = { 32/*496us*/, 64, 128/*2ms*/, 40,
-        80/*10ms*/, 162, 101, 201, 101, 252 };
-// only for information - actual code needs 2 bytes more than code using this table, but this table takes 10 byte of RAM/Stack
-const uint8_t CTCPrescaleValueforTimebase[TIMEBASE_NUMBER_OF_ENTRIES - TIMEBASE_NUMBER_OF_FAST_MODES] = { TIMER0_PRESCALE8/*496us*/,
-TIMER0_PRESCALE8, TIMER0_PRESCALE8/*2ms*/, TIMER0_PRESCALE64,
-TIMER0_PRESCALE64/*10ms*/, TIMER0_PRESCALE64, TIMER0_PRESCALE256, TIMER0_PRESCALE256, TIMER0_PRESCALE1024,
-TIMER0_PRESCALE1024 };
+ * 13 200ms    PRESCALE128  8  6464  200384   517120     1  1024   64  101      x
+ * 14 500ms    PRESCALE128  8 16128  499968  5160960     1  1024   64  252      x
+ *                                                                      postscaler
+ * 15    1s    PRESCALE128  8 32256  999936              1  1024   64  252  2   x
+ * 16    2s    PRESCALE128  8 64512 1999872              1  1024   64  252  4   x
+ * 17    5s    PRESCALE128  8 161280 4999680             1  1024   64  252 10   x
+ *
+ * Arbitrary sample periods from 16 us up are set by setUserSamplePeriod().
+ */
+
+/*
+ * One entry per timebase index.
+ * ExactDivMicros is for 31 grid - for period and frequency
+ * Since prescale PRESCALE4 has bad quality use PRESCALE8 for 201 us range and display each value twice
+ * Trigger timeout: Try to have the time for showing one display as trigger timeout
+ * Don't go below 1/10 of a second (30 * 256 samples) and above 3 seconds (900)
+ * 10 ms Range => timeout = 100 millisecond
+ * 20 ms => 200 ms, 50 ms => 500 ms, 100 ms => 1s, 200 ms => 2s, 500 ms => 3s
+ * Trigger is always running with ADC at free running mode at 1 us clock => 13 us per conversion
+ * which gives 77k samples for 1 second
+ * First sample delay: Wait 15 micros for 1 ms and 47 micros for 2 ms range in order to align first sample to timer0 clock.
+ */
+constexpr struct TimebaseDescriptorStruct TimebaseDescriptors[TIMEBASE_NUMBER_OF_ENTRIES] PROGMEM = {
+/*  ExactDivMicros            Print Timeout ADC prescale     Timer0 prescale      CTC Postscaler XScale First sample delay       Flags */
+{ 100.75 /*(31*13*0,25)*/,    10,  30,    ADC_PRESCALE4,   0,                   0,   1,  10, 0,                          TIMEBASE_FLAG_FAST_MODE | TIMEBASE_FLAG_ULTRAFAST_MODE },
+{ 100.75,                     20,  30,    ADC_PRESCALE4,   0,                   0,   1,  5,  0,                          TIMEBASE_FLAG_FAST_MODE | TIMEBASE_FLAG_ULTRAFAST_MODE },
+{ 100.75,                     50,  30,    ADC_PRESCALE4,   0,                   0,   1,  2,  0,                          TIMEBASE_FLAG_FAST_MODE | TIMEBASE_FLAG_ULTRAFAST_MODE },
+{ 201.5,                      101, 30,    ADC_PRESCALE8,   0,                   0,   1,  2,  0,                          TIMEBASE_FLAG_FAST_MODE },
+{ 201.5 /*(31*13*0,5)*/,      201, 30,    ADC_PRESCALE8,   0,                   0,   1,  1,  0,                          TIMEBASE_FLAG_FAST_MODE },
+{ 496 /*(31*16*1)*/,          496, 30,    ADC_PRESCALE16,  TIMER0_PRESCALE8,    32,  1,  1,  0,                          0 },
+{ 992 /*(31*16*2)*/,          1,   30,    ADC_PRESCALE32,  TIMER0_PRESCALE8,    64,  1,  1,  15 * 4,                     TIMEBASE_FLAG_MILLIS },
+{ 1984 /*(31*16*4)*/,         2,   30,    ADC_PRESCALE64,  TIMER0_PRESCALE8,    128, 1,  1,  47 * 4,                     TIMEBASE_FLAG_MILLIS },
+{ 4960 /*(31*20*8)*/,         5,   30,    ADC_PRESCALE128, TIMER0_PRESCALE64,   40,  1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS },
+{ 9920 /*(31*40*8)*/,         10,  30,    ADC_PRESCALE128, TIMER0_PRESCALE64,   80,  1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS },
+{ 20088 /*(31*81*8)*/,        20,  60,    ADC_PRESCALE128, TIMER0_PRESCALE64,   162, 1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS },
+{ 50096 /*(31*202*8)*/,       50,  150,   ADC_PRESCALE128, TIMER0_PRESCALE256,  101, 1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE },
+{ 99696 /*(31*201*16)*/,      100, 300,   ADC_PRESCALE128, TIMER0_PRESCALE256,  201, 1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE },
+{ 200384 /*(31*808*8)*/,      200, 600,   ADC_PRESCALE128, TIMER0_PRESCALE1024, 101, 1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE },
+{ 499968 /*(31*2016*8)*/,     500, 900,   ADC_PRESCALE128, TIMER0_PRESCALE1024, 252, 1,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_MILLIS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE },
+{ 999936 /*(31*4032*8)*/,     1,   900,   ADC_PRESCALE128, TIMER0_PRESCALE1024, 252, 2,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_SECONDS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE },
+{ 1999872 /*(31*8064*8)*/,    2,   900,   ADC_PRESCALE128, TIMER0_PRESCALE1024, 252, 4,  1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_SECONDS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE },
+{ 4999680 /*(31*20160*8)*/,   5,   900,   ADC_PRESCALE128, TIMER0_PRESCALE1024, 252, 10, 1,  TIMEBASE_FIRST_SAMPLE_SKIP, TIMEBASE_FLAG_SECONDS | TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE } };
+
+/*
+ * Compile time checks of timebase table
+ */
+constexpr uint16_t getTimer0PrescaleDivider(uint8_t aTimer0Prescale) {
+    return (aTimer0Prescale == TIMER0_PRESCALE8) ? 8 : ((aTimer0Prescale == TIMER0_PRESCALE64) ? 64 :
+            ((aTimer0Prescale == TIMER0_PRESCALE256) ? 256 : ((aTimer0Prescale == TIMER0_PRESCALE1024) ? 1024 : 0)));
+}
+// CPU clock cycles between 2 samples
+constexpr uint32_t getSamplePeriodClockCycles(uint8_t aTimebaseIndex) {
+    return (TimebaseDescriptors[aTimebaseIndex].Flags & TIMEBASE_FLAG_FAST_MODE) ?
+            ((uint32_t) ADC_CYCLES_PER_CONVERSION << TimebaseDescriptors[aTimebaseIndex].ADCPrescale) :
+            ((uint32_t) TimebaseDescriptors[aTimebaseIndex].CTCValue
+                    * getTimer0PrescaleDivider(TimebaseDescriptors[aTimebaseIndex].Timer0Prescale)
+                    * TimebaseDescriptors[aTimebaseIndex].SamplePostscaler);
+}
+// ExactDivMicros must match prescaler and CTC values and ADC conversion must be finished before next timer0 trigger
+constexpr bool isTimebaseDescriptorValid(uint8_t aTimebaseIndex) {
+    return TimebaseDescriptors[aTimebaseIndex].ExactDivMicros
+            == ((float) (getSamplePeriodClockCycles(aTimebaseIndex) * TIMING_GRID_WIDTH)) / (F_CPU / 1000000L)
+            && ((uint32_t) ADC_CYCLES_PER_CONVERSION << TimebaseDescriptors[aTimebaseIndex].ADCPrescale)
+                    <= getSamplePeriodClockCycles(aTimebaseIndex) / TimebaseDescriptors[aTimebaseIndex].SamplePostscaler
+            && (!(TimebaseDescriptors[aTimebaseIndex].Flags & TIMEBASE_FLAG_ULTRAFAST_MODE)
+                    || (TimebaseDescriptors[aTimebaseIndex].Flags & TIMEBASE_FLAG_FAST_MODE));
+}
+constexpr bool areTimebaseDescriptorsValid(uint8_t aTimebaseIndex) {
+    return aTimebaseIndex >= TIMEBASE_NUMBER_OF_ENTRIES
+            || (isTimebaseDescriptorValid(aTimebaseIndex) && areTimebaseDescriptorsValid(aTimebaseIndex + 1));
+}
+static_assert(areTimebaseDescriptorsValid(0), "TimebaseDescriptors[]: ExactDivMicros does not match prescaler and CTC values or ADC conversion is too slow");
 
 /*
  * storage for millis value to enable compensation for interrupt disable at signal acquisition etc.
  */
 extern volatile unsigned long timer0_millis;
+extern volatile unsigned long timer0_overflow_count; // incremented by timer2 overflow, see ISR_ALIAS below
 
 /****************************************
  * Automatic triggering and range stuff
  */
-#define TRIGGER_WAIT_NUMBER_OF_SAMPLES 3300 // Number of samples (<=112us) used for detecting the trigger condition
+#define TRIGGER_WAIT_NUMBER_OF_SAMPLES 3300 // Number of samples (<=112us) used for detecting the trigger condition. Is also slice for single shot wait.
 #define ADC_CYCLES_PER_CONVERSION 13
+/*
+ * Sample overrun detection measures the time between 2 ADC ISR calls with the 8 bit timer2 count, which wraps after 16384 cycles.
+ * Up to this sample period, a delay of the ISR by one more sample period is still measured.
+ * Longer sample periods have no overrun risk, since no ISR blocks for more than 0.5 ms.
+ */
+#define OVERRUN_CHECK_SAMPLE_PERIOD_CYCLES_MAX (128 * 64)
 #define SCALE_CHANGE_DELAY_MILLIS 2000
 
 #define ADC_MAX_CONVERSION_VALUE (1024 -1) // 10 bit
@@ -260,6 +306,37 @@ extern volatile unsigned long timer0_millis;
  * Measurement control values
  *****************************/
 struct MeasurementControlStruct MeasurementControl;
+TriggerStatisticsStruct TriggerStatistics;
+#ifdef SUPPORT_DATA_LOGGER
+DataLoggerStruct DataLogger;
+#endif
+#ifdef SUPPORT_TREND_RECORDER
+TrendRecorderStruct TrendRecorder;
+#endif
+LoopTaskControlStruct LoopTaskControl;
+#ifdef TRACE_EVENTS
+TraceBufferStruct TraceBuffer;
+#endif
+#ifdef MEASURE_ISR_TIMING
+ISRTimingStruct ISRTiming[ISR_TIMING_NUMBER_OF_ISRS];
+#endif
+
+/*
+ * Expected maximum runtime of the deferred loop tasks at 9600 baud, see LOOP_TASK_*.
+ * Only a statistic, exceeding it is counted and shown on the settings page, but the task is not interrupted.
+ */
+const uint16_t LoopTaskBudgetMillis[LOOP_TASK_NUMBER_OF_TASKS] PROGMEM = { 300, 600, 150, 800, 120 };
+
+/*
+ * Reference waveforms, stored as display values
+ */
+uint8_t ReferenceSlots[REFERENCE_SLOT_COUNT][REMOTE_DISPLAY_WIDTH] EEMEM;
+const uint16_t ReferenceColors[REFERENCE_SLOT_COUNT] PROGMEM = { COLOR_REFERENCE_0, COLOR_REFERENCE_1, COLOR_REFERENCE_2 };
+
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+const uint16_t ChartPaletteColors[BD_PALETTE_SIZE] PROGMEM = { COLOR_BACKGROUND_DSO, COLOR_DATA_RUN, COLOR_DATA_HOLD,
+COLOR_DATA_HISTORY, COLOR_GRID_LINES, COLOR_TRIGGER_LINE, COLOR_MAX_MIN_LINE, COLOR_VOLTAGE_PICKER };
+#endif
 
 /*
  * Display control
@@ -317,6 +394,18 @@ DataBufferStruct DataBufferControl __attribute__((section(".noinit")));
  *******************************************************************************************/
 
 void acquireDataFast(void);
+inline void startTimer2MillisCountdown(uint16_t aMillis) __attribute__((always_inline));
+inline uint32_t getTimer2Timestamp(void) __attribute__((always_inline));
+void compensateMillisAndEnableTimer2(uint32_t aDisabledMicros);
+#ifdef SUPPORT_DATA_LOGGER
+inline void handleDataLoggerConversion(uint16_t aValue) __attribute__((always_inline));
+#endif
+inline void setOverrunCheckReference(void) __attribute__((always_inline));
+inline void handleADCInterrupt(void) __attribute__((always_inline));
+#ifdef TRACE_EVENTS
+inline void traceEvent(uint8_t aEvent, uint8_t aData) __attribute__((always_inline));
+#endif
+void addTriggerEvent(uint32_t aTimestamp);
 
 // Measurement auto control stuff (trigger, range + offset)
 void computeAutoTrigger(void);
@@ -336,6 +425,7 @@ void activateChartGui(void);
 // BUTTON handler section
 
 // Graphical output section
+uint8_t * expandDataBuffer(uint8_t *aByteBuffer);
 void clearDisplayedChart(uint8_t * aDisplayBufferPtr);
 void drawRemainingDataBufferValues(void);
 
@@ -356,6 +446,12 @@ void initDisplay(void) {
     BlueDisplay1.setFlagsAndSize(
             BD_FLAG_FIRST_RESET_ALL | BD_FLAG_USE_MAX_SIZE | BD_FLAG_LONG_TOUCH_ENABLE | BD_FLAG_ONLY_TOUCH_MOVE_DISABLE,
             REMOTE_DISPLAY_WIDTH, REMOTE_DISPLAY_HEIGHT);
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+    // colors of chart and lines, they can then be sent with compact draw functions
+    for (uint8_t i = 0; i < sizeof(ChartPaletteColors) / sizeof(ChartPaletteColors[0]); ++i) {
+        BlueDisplay1.setPaletteColor(i, pgm_read_word(&ChartPaletteColors[i]));
+    }
+#endif
     BlueDisplay1.setCharacterMapping(0xD1, 0x21D1); // Ascending in UTF16 - for printInfo()
     BlueDisplay1.setCharacterMapping(0xD2, 0x21D3); // Descending in UTF16 - for printInfo()
     BlueDisplay1.setCharacterMapping(0xD4, 0x2227); // UP (logical AND) in UTF16
@@ -409,6 +505,16 @@ void setup() {
     MeasurementControl.TriggerSlopeRising = true;
     MeasurementControl.TriggerMode = TRIGGER_MODE_AUTOMATIC;
     MeasurementControl.isSingleShotMode = false;
+    MeasurementControl.SequenceNumberOfShots = 0;
+    resetTriggerStatistics();
+
+#ifdef SUPPORT_DATA_LOGGER
+    DataLogger.ChannelMask = _BV(0);
+    DataLogger.IntervalSeconds = DATA_LOGGER_INTERVAL_SECONDS_DEFAULT;
+#endif
+#ifdef SUPPORT_TREND_RECORDER
+    TrendRecorder.IntervalSeconds = TREND_INTERVAL_SECONDS_DEFAULT;
+#endif
 
     /*
      * Read input pins to determine attenuator type
@@ -508,6 +614,9 @@ void setup() {
     setVCCValue();
     BlueDisplay1.playFeedbackTone(FEEDBACK_TONE_OK);
 
+#ifdef SUPPORT_TREND_RECORDER
+    clearTrendRecorder();
+#endif
     initStackFreeMeasurement();
 
 }
@@ -518,11 +627,20 @@ void setup() {
 // noreturn saves program space!
 void __attribute__((noreturn)) loop(void) {
     static uint32_t sMillisOfLastInfoOutput;
+    static uint16_t sLoopCount; // main loops since last info output, shows the CPU time left by the ISRs
 
     bool sDoInfoOutput = true; // Output info at least every second for settings page, single shot or trigger not found
 
     for (;;) {
+#ifdef TRACE_EVENTS
+        if (remoteEvent.EventType != EVENT_NO_EVENT) {
+            TRACE_EVENT(TRACE_EVENT_RECEIVED, remoteEvent.EventType);
+        }
+#endif
         checkAndHandleEvents();
+        sLoopCount++;
+        // keeps the DC voltage also if no display is connected
+        loopDCSource();
         if (BlueDisplay1.mConnectionEstablished) {
 
             /*
@@ -531,6 +649,10 @@ void __attribute__((noreturn)) loop(void) {
             if (millis() - sMillisOfLastInfoOutput > MILLIS_BETWEEN_INFO_OUTPUT) {
                 sMillisOfLastInfoOutput = millis();
                 sDoInfoOutput = true;
+                if (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS) {
+                    printMainLoopRate(sLoopCount);
+                }
+                sLoopCount = 0;
             }
 
             if (MeasurementControl.isRunning) {
@@ -546,38 +668,53 @@ void __attribute__((noreturn)) loop(void) {
                      */
 
                     /*
-                     * Enable Timer0 overflow interrupt again
+                     * Enable Timer2 overflow interrupt again
                      * and compensate for missing ticks because timer was disabled not to disturb acquisition.
                      * 320.0 / 31.0 = divs per screen
-                     * 4 * 256 = micro seconds per interrupt
                      */
-                    uint32_t tCompensation = ((320.0 / 31.0) / (4 * 256))
-                            * pgm_read_float(&TimebaseExactDivValuesMicros[MeasurementControl.TimebaseIndex]);
-                    timer0_millis += tCompensation;
-                    TIMSK2 = _BV(TOIE2); // Enable overflow interrupts which replaces the Arduino millis() interrupt
+                    compensateMillisAndEnableTimer2((320.0 / 31.0) * MeasurementControl.TimebaseDescriptor.ExactDivMicros);
+
+                    // keep lost samples of this capture for info, since startAcquisition() resets the counter
+                    DataBufferControl.SampleOverrunCountOfShot[getDisplayedShotIndex()] = MeasurementControl.SampleOverrunCount;
+
+                    if (MeasurementControl.TriggerTimestampIsValid) {
+                        // statistics are also updated if nothing is drawn
+                        MeasurementControl.TriggerTimestampIsValid = false;
+                        addTriggerEvent(MeasurementControl.TriggerTimestamp);
+                    }
+
+                    if (MeasurementControl.SequenceShotIndex + 1 < MeasurementControl.SequenceNumberOfShots) {
+                        /*
+                         * Sequence -> arm next shot immediately without any drawing
+                         */
+                        MeasurementControl.SequenceShotIndex++;
+                        startAcquisition();
+                        continue;
+                    }
 
                     /*
-                     * Handle cyclicly print info or refresh buttons
+                     * Handle cyclicly print info or refresh buttons.
+                     * Only request it here, it is done by runPendingLoopTask() after start of next acquisition.
                      */
                     if (sDoInfoOutput) {
                         sDoInfoOutput = false;
 
                         if (DisplayControl.DisplayPage == DISPLAY_PAGE_CHART) {
-                            drawGridLinesWithHorizLabelsAndTriggerLine();
+#ifndef USE_REMOTE_LAYERS
+                            LoopTaskControl.PendingMask |= _BV(LOOP_TASK_GRID);
+#endif
+                            static uint8_t sReferenceRefreshCounter;
+                            if (++sReferenceRefreshCounter >= REFERENCE_REFRESH_INFO_OUTPUT_COUNT) {
+                                sReferenceRefreshCounter = 0;
+                                LoopTaskControl.PendingMask |= _BV(LOOP_TASK_REFERENCE);
+                            }
                             if (DisplayControl.showInfoMode != INFO_MODE_NO_INFO) {
-                                printInfo();
+                                // data buffer is overwritten by next acquisition, so compute values now
+                                computePeriodFrequency();
+                                LoopTaskControl.PendingMask |= _BV(LOOP_TASK_INFO);
                             }
-                        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS) {
-                            // refresh buttons
-                            drawDSOSettingsPage();
-                        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_FREQUENCY) {
-                            // refresh buttons
-                            drawFrequencyGeneratorPage();
-#ifndef AVR
-                        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_MORE_SETTINGS) {
-                            // refresh buttons
-                            drawDSOMoreSettingsPage();
-#endif
+                        } else {
+                            LoopTaskControl.PendingMask |= _BV(LOOP_TASK_PAGE_REFRESH);
                         }
                     }
 
@@ -591,6 +728,7 @@ void __attribute__((noreturn)) loop(void) {
                          */
                         MeasurementControl.StopRequested = false;
                         MeasurementControl.isRunning = false;
+                        LoopTaskControl.PendingMask = 0; // redrawDisplay() below does it all
                         if (MeasurementControl.ADCReference != DEFAULT) {
                             // get new VCC Value
                             setVCCValue();
@@ -600,12 +738,23 @@ void __attribute__((noreturn)) loop(void) {
                             // Clear single shot character
                             clearSingleshotMarker();
                         }
+                        if (MeasurementControl.SequenceNumberOfShots != 0) {
+                            // show first shot of sequence
+                            MeasurementControl.SequenceShotIndex = 0;
+                            DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
+                        }
                         redrawDisplay();
+                        if (MeasurementControl.SequenceNumberOfShots != 0) {
+                            printSingleshotMarker();
+                        }
                     } else {
                         /*
                          * Normal loop-> process data, draw new chart, and start next acquisition
                          */
                         uint8_t tLastTriggerDisplayValue = DisplayControl.TriggerLevelDisplayValue;
+#ifdef SUPPORT_TREND_RECORDER
+                        addTrendValues();
+#endif
                         computeAutoTrigger();
                         computeAutoRange();
                         computeAutoOffset();
@@ -617,9 +766,15 @@ void __attribute__((noreturn)) loop(void) {
                             drawTriggerLine();
                         }
 
+                        if (LoopTaskControl.PendingMask & _BV(LOOP_TASK_GRID)) {
+                            // grid must be drawn before the new chart and not over it
+                            runPendingLoopTask();
+                        }
                         if (!DisplayControl.DrawWhileAcquire) {
                             // normal mode => clear old chart and draw new data
+                            TRACE_EVENT(TRACE_EVENT_DRAW_START, 0);
                             drawDataBuffer(&DataBufferControl.DataBuffer[0], COLOR_DATA_RUN, DisplayControl.EraseColor);
+                            TRACE_EVENT(TRACE_EVENT_DRAW_END, 0);
                         }
                         startAcquisition();
                     }
@@ -662,32 +817,20 @@ void __attribute__((noreturn)) loop(void) {
                     printInfo(false);
                 }
 
-                /*
-                 * Handle milliseconds delay - not timer overflow proof
-                 */
-                if (MeasurementControl.TriggerStatus == TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY) {
-                    if (MeasurementControl.TriggerDelayMillisEnd == 0) {
-                        // initialize value since this can not be efficiently done in ISR
-                        MeasurementControl.TriggerDelayMillisEnd = millis() + MeasurementControl.TriggerDelayMillisOrMicros;
-                    } else if (millis() > MeasurementControl.TriggerDelayMillisEnd) {
-                        /*
-                         * Start acquisition
-                         */
-                        MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND;
-                        if (MeasurementControl.AcquisitionFastMode) {
-                            // NO Interrupt in FastMode
-                            ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
-                        } else {
-                            //  enable ADC interrupt, start with free running mode,
-                            ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | ADC_PRESCALE_FOR_TRIGGER_SEARCH | _BV(ADIE);
-                        }
-                    }
+                if (!DataBufferControl.DataBufferFull) {
+                    runPendingLoopTask();
                 }
             } else {
 
                 /*
                  * Analyze mode here
                  */
+#ifdef SUPPORT_DATA_LOGGER
+                if (DataLogger.isRunning) {
+                    loopDataLogger();
+                }
+#endif
+                runPendingLoopTask();
                 if (sDoInfoOutput && DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS) {
                     sDoInfoOutput = false;
                     /*
@@ -695,6 +838,7 @@ void __attribute__((noreturn)) loop(void) {
                      */
                     printVCCAndTemperature();
                     printFreeStack();
+                    printTriggerStatistics();
                 }
             }
 
@@ -717,6 +861,31 @@ void __attribute__((noreturn)) loop(void) {
                     //not needed here, because is contains only checkAndHandleEvents()
                     // loopFrequencyGeneratorPage();
                 }
+#ifdef SUPPORT_DATA_LOGGER
+            } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_DATA_LOGGER) {
+                if (sBackButtonPressed) {
+                    sBackButtonPressed = false;
+                    if (DataLogger.isRunning) {
+                        stopDataLogger();
+                    }
+                    DisplayControl.DisplayPage = DISPLAY_PAGE_START;
+                    redrawDisplay();
+                }
+#endif
+            } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_TREND || DisplayControl.DisplayPage == DISPLAY_PAGE_REFERENCE) {
+                if (sBackButtonPressed) {
+                    sBackButtonPressed = false;
+                    DisplayControl.DisplayPage = DISPLAY_PAGE_START;
+                    redrawDisplay();
+                }
+#ifdef MEASURE_ISR_TIMING
+            } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_ISR_TIMING) {
+                if (sBackButtonPressed) {
+                    sBackButtonPressed = false;
+                    DisplayControl.DisplayPage = DISPLAY_PAGE_SETTINGS;
+                    redrawDisplay();
+                }
+#endif
             }
         } // BlueDisplay1.mConnectionEstablished
 
@@ -724,6 +893,71 @@ void __attribute__((noreturn)) loop(void) {
 }
 /* Main loop end */
 
+/*
+ * Runs the pending deferred task with the highest priority and updates its statistics.
+ * Only one task per call, so the acquired data and GUI events are handled after each task.
+ * A task runs to its end, so it delays the next acquired data by its runtime.
+ * Runtime is measured with millis(), which stops if an acquisition is triggered during the task. Then it is not evaluated.
+ */
+void runPendingLoopTask(void) {
+    uint8_t tPendingMask = LoopTaskControl.PendingMask;
+    if (tPendingMask == 0) {
+        return;
+    }
+    uint8_t tTaskIndex = 0;
+    while (!(tPendingMask & 0x01)) {
+        tPendingMask >>= 1;
+        tTaskIndex++;
+    }
+    LoopTaskControl.PendingMask &= ~_BV(tTaskIndex);
+
+    bool tMillisIsRunning = TIMSK2 & _BV(TOIE2);
+    uint32_t tStartMillis = millis();
+
+    if (tTaskIndex == LOOP_TASK_PAGE_REFRESH) {
+        if (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS) {
+            // refresh buttons
+            drawDSOSettingsPage();
+            printLoopTaskStatistics();
+#ifdef MEASURE_ISR_TIMING
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_ISR_TIMING) {
+            printISRTimingHistograms();
+#endif
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_FREQUENCY) {
+            // refresh buttons
+            drawFrequencyGeneratorPage();
+#ifndef AVR
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_MORE_SETTINGS) {
+            // refresh buttons
+            drawDSOMoreSettingsPage();
+#endif
+        }
+    } else if (tTaskIndex == LOOP_TASK_STORE_REFERENCE) {
+        if (!storeReferenceChunk()) {
+            LoopTaskControl.PendingMask |= _BV(LOOP_TASK_STORE_REFERENCE);
+        }
+    } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_CHART) {
+        if (tTaskIndex == LOOP_TASK_GRID) {
+            drawGridLinesWithHorizLabelsAndTriggerLine();
+        } else if (tTaskIndex == LOOP_TASK_REFERENCE) {
+            drawReferenceCharts();
+        } else {
+            printInfo(false);
+        }
+    }
+
+    if (tMillisIsRunning && (TIMSK2 & _BV(TOIE2))) {
+        LoopTaskStatisticsStruct * tStatistics = &LoopTaskControl.Statistics[tTaskIndex];
+        uint16_t tMillis = millis() - tStartMillis;
+        if (tStatistics->MaxMillis < tMillis) {
+            tStatistics->MaxMillis = tMillis;
+        }
+        if (tMillis > pgm_read_word(&LoopTaskBudgetMillis[tTaskIndex]) && tStatistics->BudgetExceededCount != 0xFF) {
+            tStatistics->BudgetExceededCount++;
+        }
+    }
+}
+
 /************************************************************************
  * Measurement section
  ************************************************************************/
@@ -733,43 +967,57 @@ void __attribute__((noreturn)) loop(void) {
  * sets ADC status register including prescaler
  */
 void startAcquisition(void) {
+    TRACE_EVENT(TRACE_EVENT_START_ACQUISITION, MeasurementControl.TimebaseIndex);
+    completeReferenceStore(); // before acquisition overwrites DataBuffer
+    uint8_t * tDataBufferStart = &DataBufferControl.DataBuffer[0];
     DataBufferControl.AcquisitionSize = REMOTE_DISPLAY_WIDTH;
-    DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[REMOTE_DISPLAY_WIDTH - 1];
-    if (MeasurementControl.StopRequested) {
+    if (MeasurementControl.SequenceNumberOfShots != 0) {
+        // each shot of a sequence has its own screen in data buffer
+        tDataBufferStart += MeasurementControl.SequenceShotIndex * REMOTE_DISPLAY_WIDTH;
+    } else if (MeasurementControl.StopRequested) {
         DataBufferControl.AcquisitionSize = DATABUFFER_SIZE;
-        DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
     }
+    DataBufferControl.DataBufferEndPointer = tDataBufferStart + (DataBufferControl.AcquisitionSize - 1);
     /*
      * setup new interrupt cycle only if not to be stopped
      */
-    DataBufferControl.DataBufferNextInPointer = &DataBufferControl.DataBuffer[0];
-    DataBufferControl.DataBufferNextDrawPointer = &DataBufferControl.DataBuffer[0];
+    DataBufferControl.DataBufferNextInPointer = tDataBufferStart;
+    DataBufferControl.DataBufferNextDrawPointer = tDataBufferStart;
     DataBufferControl.DataBufferNextDrawIndex = 0;
     MeasurementControl.IntegrateValueForAverage = 0;
+    MeasurementControl.SampleOverrunCount = 0;
     DataBufferControl.DataBufferFull = false;
+#ifdef ISR_STATE_IN_GPIOR
+    loadISRStateRegisters();
+#endif
     /*
      * Timebase
      */
-    uint8_t tTimebaseIndex = MeasurementControl.TimebaseIndex;
-    if (tTimebaseIndex < TIMEBASE_NUMBER_OF_FAST_MODES) {
-        MeasurementControl.AcquisitionFastMode = true;
-    } else {
-        MeasurementControl.AcquisitionFastMode = false;
-    }
+    MeasurementControl.AcquisitionFastMode = MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_FAST_MODE;
     /*
      * get hardware prescale value
      */
-    if (tTimebaseIndex < TIMEBASE_NUMBER_OF_FAST_PRESCALE) {
-        MeasurementControl.TimebaseHWValue = ADCPrescaleValueforTimebase[tTimebaseIndex];
-    } else {
-        MeasurementControl.TimebaseHWValue = ADC_PRESCALE_MAX_VALUE;
+    MeasurementControl.TimebaseHWValue = MeasurementControl.TimebaseDescriptor.ADCPrescale;
+
+    /*
+     * Sample overrun detection only for the ISR timebases with timer0 prescaler 8 and 64 and short sample periods
+     */
+    MeasurementControl.OverrunCheckSamplePeriodCycles = 0;
+    if (!MeasurementControl.AcquisitionFastMode && MeasurementControl.TimebaseDescriptor.Timer0Prescale <= TIMER0_PRESCALE64) {
+        uint8_t tTimer0Divider = (MeasurementControl.TimebaseDescriptor.Timer0Prescale == TIMER0_PRESCALE8) ? 8 : 64;
+        uint16_t tSamplePeriodCycles = MeasurementControl.TimebaseDescriptor.CTCValue * tTimer0Divider;
+        if (tSamplePeriodCycles <= OVERRUN_CHECK_SAMPLE_PERIOD_CYCLES_MAX) {
+            MeasurementControl.OverrunCheckTimer0Divider = tTimer0Divider;
+            MeasurementControl.OverrunCheckSamplePeriodCycles = tSamplePeriodCycles;
+        }
     }
 
     MeasurementControl.TriggerStatus = TRIGGER_STATUS_START;
-    // fast mode checks the INT1 pin directly and need no interrupt
-    if (MeasurementControl.TriggerMode == TRIGGER_MODE_EXTERN && !MeasurementControl.AcquisitionFastMode) {
+    MeasurementControl.TriggerDelayTimerIsRunning = false;
+    TIMSK2 &= ~_BV(OCIE2B); // stop a running milliseconds trigger delay
+    if (MeasurementControl.TriggerMode == TRIGGER_MODE_EXTERN) {
         /*
-         * wait for external trigger with INT1 pin change interrupt - NO timeout
+         * wait for external trigger with INT0 pin change interrupt - NO timeout for slow modes
          */
         if (MeasurementControl.TriggerSlopeRising) {
             EICRA = _BV(ISC01) | _BV(ISC00);
@@ -779,8 +1027,14 @@ void startAcquisition(void) {
 
         // clear interrupt bit
         EIFR = _BV(INTF0);
-        // enable interrupt on next change
-        EIMSK = _BV(INT0);
+        if (MeasurementControl.AcquisitionFastMode) {
+            // ADC is idle, acquireDataFast() polls the interrupt bit and starts first conversion at the trigger edge
+            ADCSRB = 0; // free running mode
+            ADCSRA = _BV(ADEN) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
+        } else {
+            // enable interrupt on next change
+            EIMSK = _BV(INT0);
+        }
         return;
     } else {
         // start with waiting for triggering condition
@@ -795,9 +1049,138 @@ void startAcquisition(void) {
         // NO Interrupt in FastMode
         ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
     } else {
-        //  enable ADC interrupt, start with fast free running mode for trigger search.
-        ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | ADC_PRESCALE_FOR_TRIGGER_SEARCH | _BV(ADIE);
+        //  enable ADC interrupt, start with free running mode for trigger search.
+        ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TriggerSearchADCPrescale | _BV(ADIE);
+    }
+}
+
+/*
+ * Use timer0 as one shot timer for the microseconds trigger delay.
+ * The delay is split into a first period of 16 to 256 cycles followed by periods of 256 cycles.
+ * The compare match at the end of the delay starts the first conversion by hardware,
+ * so the delay is cycle exact and interrupts (millis(), UART) are still served during the delay.
+ * Always inline for the same reason as addISRTiming() in ISRTiming.h.
+ */
+inline void startTriggerDelayTimer(uint16_t aDelayMicros) __attribute__((always_inline));
+void startTriggerDelayTimer(uint16_t aDelayMicros) {
+    // Stop free running mode and speed up an ongoing conversion (see ADC ISR). => 10 to 12 clocks until conversion finishes
+    ADCSRA = _BV(ADEN) | _BV(ADIF);
+    TCCR0B = 0; // stop timer0
+    TCNT0 = 0;
+    if (aDelayMicros < TRIGGER_DELAY_MICROS_TIMER0_MIN) {
+        // otherwise the ADC may still be busy at the compare match and ignore the trigger
+        aDelayMicros = TRIGGER_DELAY_MICROS_TIMER0_MIN;
+    }
+    aDelayMicros--;
+    OCR0A = (((aDelayMicros & 0x0F) + 1) << 4) - 1; // first period is 16 to 256 cycles
+    MeasurementControl.TriggerDelayTimer0PeriodsRemaining = aDelayMicros >> 4;
+    MeasurementControl.TriggerDelayTimerIsRunning = true;
+    MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY;
+    ADCSRB = _BV(ADTS0) | _BV(ADTS1); // Trigger source Timer/Counter0 Compare Match A
+    TIFR0 = _BV(OCF0A); // reset int flag
+    TCCR0B = TIMER0_PRESCALE0; // start timer0 with CPU clock
+    if (MeasurementControl.TriggerDelayTimer0PeriodsRemaining == 0) {
+        /*
+         * First compare match is end of delay -> enable auto trigger.
+         * Wait for the last trigger search conversion to end before, otherwise its ADIF would be taken as first sample.
+         * Writing ADIF resets the flag set by this conversion.
+         */
+        loop_until_bit_is_clear(ADCSRA, ADSC);
+        ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue | _BV(ADIE);
+    }
+}
+
+/*
+ * Use compare B of the free running timer2 for the milliseconds trigger delay.
+ * Adding 250 ticks to OCR2B for each match gives one interrupt per millisecond,
+ * so the time is only counted down and needs no overflow prone compare with millis().
+ */
+void startTimer2MillisCountdown(uint16_t aMillis) {
+#ifdef TIMER2_IS_TIMER3
+    /*
+     * OCR3B is only updated at TOP, so keep it fixed and count periods of 256 ticks = 1.024 ms.
+     * The new value is loaded at the next TOP, so the first match is one full period after now.
+     */
+    uint16_t tPeriods = ((uint32_t) aMillis * TRIGGER_DELAY_TIMER2_TICKS_PER_MILLI) >> 8;
+    if (tPeriods == 0) {
+        tPeriods = 1;
+    }
+    MeasurementControl.Timer2MillisRemaining = tPeriods;
+    OCR2B = TCNT2;
+#else
+    MeasurementControl.Timer2MillisRemaining = aMillis;
+    OCR2B = (uint8_t) (TCNT2 + TRIGGER_DELAY_TIMER2_TICKS_PER_MILLI);
+#endif
+    TIFR2 = _BV(OCF2B); // reset int flag
+    TIMSK2 = _BV(TOIE2) | _BV(OCIE2B);
+}
+
+ISR(TIMER2_COMPB_vect) {
+    MeasurementControl.Timer2MillisRemaining--;
+    if (MeasurementControl.Timer2MillisRemaining != 0) {
+#ifndef TIMER2_IS_TIMER3
+        OCR2B = (uint8_t) (OCR2B + TRIGGER_DELAY_TIMER2_TICKS_PER_MILLI);
+#endif
+        return;
     }
+    TIMSK2 = _BV(TOIE2); // disable compare B interrupt
+    /*
+     * End of delay -> start acquisition with timer0 triggered ADC and first conversion now.
+     * ADC ISR takes this conversion as first data, see TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY
+     */
+    ADCSRB = _BV(ADTS0) | _BV(ADTS1); // Trigger source Timer/Counter0 Compare Match A
+    TCNT0 = 0;
+    TIFR0 = _BV(OCF0A); // reset int flag
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue | _BV(ADIE);
+    // latency of this ISR in 4 us ticks is the delay error
+    MeasurementControl.TriggerDelayMillisErrorMicros = (uint8_t) (TCNT2 - OCR2B) * 4;
+}
+
+/*
+ * Time waited for the external trigger in fast modes, while the timer2 overflow interrupt was disabled.
+ * Is added by the next call of compensateMillisAndEnableTimer2().
+ */
+uint16_t sTriggerWaitMicros;
+
+/*
+ * Adds the time for which the timer2 overflow interrupt was disabled to millis() and the overflow count and enables the interrupt again.
+ * The parts below 1 ms and below one overflow period of 1024 us are carried to the next call, so millis() does not drift with each acquisition.
+ * One overflow while disabled is latched by TOV2 and counted by the ISR directly after enabling, so it is subtracted here.
+ */
+void compensateMillisAndEnableTimer2(uint32_t aDisabledMicros) {
+    static int16_t sMillisRemainderMicros;
+    static int16_t sOverflowRemainderMicros;
+
+    int32_t tMicros = aDisabledMicros + sTriggerWaitMicros;
+    sTriggerWaitMicros = 0;
+    if (TIFR2 & _BV(TOV2)) {
+        tMicros -= 4 * 256;
+    }
+    int32_t tMillisMicros = tMicros + sMillisRemainderMicros;
+    int32_t tMillis = tMillisMicros / 1000;
+    sMillisRemainderMicros = tMillisMicros - (tMillis * 1000);
+    int32_t tOverflowMicros = tMicros + sOverflowRemainderMicros;
+    int32_t tOverflows = tOverflowMicros / (4 * 256);
+    sOverflowRemainderMicros = tOverflowMicros - (tOverflows * (4 * 256));
+
+    // timer2 interrupt is disabled here and no other ISR uses the values
+    timer0_millis += tMillis;
+    timer0_overflow_count += tOverflows;
+    TIMSK2 = _BV(TOIE2); // Enable overflow interrupts which replaces the Arduino millis() interrupt
+}
+
+/*
+ * Timer2 count extended by the overflow count of the millis() ISR. Unit is 4 us, overflow after 4.7 hours.
+ * Must be called with interrupts disabled.
+ */
+uint32_t getTimer2Timestamp(void) {
+    uint8_t tCount = TCNT2;
+    uint32_t tOverflowCount = timer0_overflow_count;
+    if ((TIFR2 & _BV(TOV2)) && tCount < 0x80) {
+        // overflow happened, but ISR not yet called
+        tOverflowCount++;
+    }
+    return (tOverflowCount << 8) | tCount;
 }
 
 /*
@@ -809,28 +1192,22 @@ ISR(INT0_vect) {
      * Disable interrupt on trigger pin
      */
     EIMSK = 0;
+    MeasurementControl.TriggerTimestamp = getTimer2Timestamp();
+    MeasurementControl.TriggerTimestampIsValid = true;
+    TRACE_EVENT(TRACE_EVENT_TRIGGER_FOUND, MeasurementControl.TriggerMode);
 
     if (MeasurementControl.TriggerDelayMode != TRIGGER_DELAY_NONE) {
         /*
          * Delay
          */
         if (MeasurementControl.TriggerDelayMode == TRIGGER_DELAY_MICROS) {
-            // It is not possible to access using internal delay handling of ISR, so duplicate code here
-            // delayMicroseconds(MeasurementControl.TriggerDelayMillisOrMicros - TRIGGER_DELAY_MICROS_ISR_ADJUST_COUNT); substituted by code below, to enable full 16 bit range
-            uint16_t tDelayMicros = MeasurementControl.TriggerDelayMillisOrMicros - TRIGGER_DELAY_MICROS_ISR_ADJUST_COUNT;
-            asm volatile (
-                    "1: sbiw %0,1" "\n\t" // 2 cycles
-                    "1: adiw %0,1" "\n\t"// 2 cycles
-                    "1: sbiw %0,1" "\n\t"// 2 cycles
-                    "1: adiw %0,1" "\n\t"// 2 cycles
-                    "1: sbiw %0,1" "\n\t"// 2 cycles
-                    "1: adiw %0,1" "\n\t"// 2 cycles
-                    "1: sbiw %0,1" "\n\t"// 2 cycles
-                    "brne .-16" : : "w" (tDelayMicros)// 16 cycles
-            );
+            // timer0 compare match at end of delay starts acquisition, see ISR(ADC_vect)
+            startTriggerDelayTimer(MeasurementControl.TriggerDelayMillisOrMicros - TRIGGER_DELAY_MICROS_ISR_ADJUST_COUNT);
+            return;
         } else {
+            // timer2 compare B ISR starts acquisition at end of delay
             MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY;
-            MeasurementControl.TriggerDelayMillisEnd = millis() + MeasurementControl.TriggerDelayMillisOrMicros;
+            startTimer2MillisCountdown(MeasurementControl.TriggerDelayMillisOrMicros);
             return;
         }
     }
@@ -840,7 +1217,7 @@ ISR(INT0_vect) {
      */
     MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND;
     //  enable ADC interrupt
-    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | ADC_PRESCALE_FOR_TRIGGER_SEARCH | _BV(ADIE);
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TriggerSearchADCPrescale | _BV(ADIE);
 }
 
 /*
@@ -848,7 +1225,7 @@ ISR(INT0_vect) {
  * Value, which mets trigger condition, is taken as first data.
  *
  * Only TRIGGER_MODE_MANUAL_TIMEOUT and TRIGGER_MODE_EXTERN is supported yet.
- * But TRIGGER_MODE_EXTERN has timeout here!
+ * TRIGGER_MODE_EXTERN has timeout here, except for single shot mode.
  */
 //#define DEBUG_ADC_TIMING
 void acquireDataFast(void) {
@@ -859,77 +1236,150 @@ void acquireDataFast(void) {
     uint8_t tTriggerStatus = TRIGGER_STATUS_START;
     uint16_t i;
     uint16_t tValueOffset = MeasurementControl.OffsetValue;
+    uint32_t tWaitStartTimestamp;
+    uint16_t tTriggerWaitSamples = 0; // samples read until internal trigger condition was met, 0 if not met in this call
 
     if (MeasurementControl.TriggerMode == TRIGGER_MODE_EXTERN) {
-        if (MeasurementControl.TriggerSlopeRising) {
-            EICRA = _BV(ISC01) | _BV(ISC00);
+        TIMSK2 = 0; // disable timer2 (millis()) interrupt to avoid jitter and signal dropouts
+
+        if (MeasurementControl.TriggerStatus == TRIGGER_STATUS_FOUND) {
+            // Single shot was stopped by Stop button -> take next value as first data
+            ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
         } else {
-            EICRA = _BV(ISC01);
+            /*
+             * The INT0 interrupt is not enabled in fast modes, but its flag latches the trigger edge.
+             * Poll the flag for TRIGGER_EXTERN_WAIT_TIMER2_OVERFLOWS timer2 periods and start the first conversion directly at the edge.
+             * An edge during the main loop is latched too and taken at the start of the next call.
+             * The latency from the trigger edge to the sample and hold of the first sample is listed in the README.
+             * The waiting time is measured by counting timer2 overflows and added to millis() at the end of acquisition.
+             */
+            uint32_t tStartTimestamp = getTimer2Timestamp(); // TIMSK2 is 0 here so no need to disable interrupts
+            uint8_t tTimer2StartCount = (uint8_t) tStartTimestamp;
+            uint8_t tTimer2Count = tTimer2StartCount;
+            uint8_t tTimer2Overflows = 0;
+            bool tTriggerFound = false;
+            do {
+                if (bit_is_set(EIFR, INTF0)) {
+                    // start first conversion as early as possible to get a fixed latency from trigger edge to first sample
+                    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
+                    tTriggerFound = true;
+                    break;
+                }
+                uint8_t tLastTimer2Count = tTimer2Count;
+                tTimer2Count = TCNT2;
+                if (tTimer2Count < tLastTimer2Count) {
+                    tTimer2Overflows++;
+                }
+            } while (tTimer2Overflows < TRIGGER_EXTERN_WAIT_TIMER2_OVERFLOWS);
+
+            uint16_t tWaitTicks = ((uint16_t) tTimer2Overflows << 8) + tTimer2Count - tTimer2StartCount;
+            if (tTriggerFound) {
+                MeasurementControl.TriggerTimestamp = tStartTimestamp + tWaitTicks;
+                MeasurementControl.TriggerTimestampIsValid = true;
+                TRACE_EVENT(TRACE_EVENT_TRIGGER_FOUND, MeasurementControl.TriggerMode);
+            } else if (MeasurementControl.isSingleShotMode) {
+                /*
+                 * End of slice without trigger -> return to main loop to handle GUI events like the Stop button
+                 */
+                compensateMillisAndEnableTimer2((uint32_t) tWaitTicks * 4);
+                return;
+            } else {
+                // timeout -> take data without trigger
+                ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
+            }
+            sTriggerWaitMicros = tWaitTicks * 4;
         }
-        EIFR = _BV(INTF0); // Do not enable interrupt since we do polling below
-        uint16_t tTimeoutCounter = 0;
-        /*
-         * Wait 65536 loops for external trigger to happen (for interrupt bit to be set)
-         */
-        do {
-            tTimeoutCounter--;
-        } while (bit_is_clear(EIFR, INTF0) && tTimeoutCounter != 0);
+        loop_until_bit_is_set(ADCSRA, ADIF);
         // get first value after trigger
         tUValue.byte.LowByte = ADCL;
         tUValue.byte.HighByte = ADCH;
+        ADCSRA |= _BV(ADIF); // clear bit to recognize next conversion has finished
 
     } else {
-        // start the first conversion and clear bit to recognize next conversion has finished
-        ADCSRA |= _BV(ADIF) | _BV(ADSC);
+        // start the first conversion (ADC is idle if trigger mode was switched from extern) and clear bit to recognize next conversion has finished
+        ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue;
 
         TIMSK2 = 0; // disable timer2 (millis()) interrupt to avoid jitter and signal dropouts
 
-        /*
-         * Wait for trigger for max. 10 screens e.g. < 20 ms
-         * if trigger condition not met it will run forever in single shot mode
-         */
-        for (i = TRIGGER_WAIT_NUMBER_OF_SAMPLES; i != 0 || MeasurementControl.isSingleShotMode; --i) {
-#ifdef DEBUG_ADC_TIMING
-            digitalWriteFast(DEBUG_PIN, HIGH); // debug pulse is 1 us for (ultra fast) PRESSCALER4 and 4 us for (fast) PRESSCALER8
-#endif
-            // wait for free running conversion to finish
+        if (MeasurementControl.TriggerStatus == TRIGGER_STATUS_FOUND) {
+            /*
+             * Single shot was stopped by Stop button -> take next value as first data
+             */
             loop_until_bit_is_set(ADCSRA, ADIF);
-#ifdef DEBUG_ADC_TIMING
-            digitalWriteFast(DEBUG_PIN, LOW);
-#endif
-            // Get value
             tUValue.byte.LowByte = ADCL;
             tUValue.byte.HighByte = ADCH;
             ADCSRA |= _BV(ADIF); // clear bit to recognize next conversion has finished
+        } else {
+            // continue with hysteresis status of last slice
+            tTriggerStatus = MeasurementControl.TriggerStatus;
+            tWaitStartTimestamp = getTimer2Timestamp(); // TIMSK2 is 0 here so no need to disable interrupts
 
             /*
-             * detect trigger slope
+             * Wait for trigger for max. 10 screens e.g. < 20 ms
+             * In single shot mode return to main loop after each 10 screens without trigger, to handle GUI events like the Stop button.
+             * A trigger slope during the main loop is detected at the first sample of the next slice (or missed, if the pulse is shorter),
+             * so the worst case added trigger latency is one main loop.
+             * This is 32 us if no event is pending, but can be some ms if a button callback redraws the screen.
              */
-            if (MeasurementControl.TriggerSlopeRising) {
-                if (tTriggerStatus == TRIGGER_STATUS_START) {
-                    // rising slope - wait for value below hysteresis level
-                    if (tUValue.Word < MeasurementControl.RawTriggerLevelHysteresis) {
-                        tTriggerStatus = TRIGGER_STATUS_AFTER_HYSTERESIS;
-                    }
-                } else {
-                    // rising slope - wait for value to rise above trigger level
-                    if (tUValue.Word > MeasurementControl.RawTriggerLevel) {
-                        break;
-                    }
-                }
-            } else {
-                if (tTriggerStatus == TRIGGER_STATUS_START) {
-                    // falling slope - wait for value above hysteresis level
-                    if (tUValue.Word > MeasurementControl.RawTriggerLevelHysteresis) {
-                        tTriggerStatus = TRIGGER_STATUS_AFTER_HYSTERESIS;
+            for (i = TRIGGER_WAIT_NUMBER_OF_SAMPLES; i != 0; --i) {
+#ifdef DEBUG_ADC_TIMING
+                digitalWriteFast(DEBUG_PIN, HIGH); // debug pulse is 1 us for (ultra fast) PRESSCALER4 and 4 us for (fast) PRESSCALER8
+#endif
+                // wait for free running conversion to finish
+                loop_until_bit_is_set(ADCSRA, ADIF);
+#ifdef DEBUG_ADC_TIMING
+                digitalWriteFast(DEBUG_PIN, LOW);
+#endif
+                // Get value
+                tUValue.byte.LowByte = ADCL;
+                tUValue.byte.HighByte = ADCH;
+                ADCSRA |= _BV(ADIF); // clear bit to recognize next conversion has finished
+
+                /*
+                 * detect trigger slope
+                 */
+                if (MeasurementControl.TriggerSlopeRising) {
+                    if (tTriggerStatus == TRIGGER_STATUS_START) {
+                        // rising slope - wait for value below hysteresis level
+                        if (tUValue.Word < MeasurementControl.RawTriggerLevelHysteresis) {
+                            tTriggerStatus = TRIGGER_STATUS_AFTER_HYSTERESIS;
+                        }
+                    } else {
+                        // rising slope - wait for value to rise above trigger level
+                        if (tUValue.Word > MeasurementControl.RawTriggerLevel) {
+                            break;
+                        }
                     }
                 } else {
-                    // falling slope - wait for value to go below trigger level
-                    if (tUValue.Word < MeasurementControl.RawTriggerLevel) {
-                        break;
+                    if (tTriggerStatus == TRIGGER_STATUS_START) {
+                        // falling slope - wait for value above hysteresis level
+                        if (tUValue.Word > MeasurementControl.RawTriggerLevelHysteresis) {
+                            tTriggerStatus = TRIGGER_STATUS_AFTER_HYSTERESIS;
+                        }
+                    } else {
+                        // falling slope - wait for value to go below trigger level
+                        if (tUValue.Word < MeasurementControl.RawTriggerLevel) {
+                            break;
+                        }
                     }
                 }
             }
+            if (i != 0) {
+                // trigger condition met, timestamp is computed after reading the buffer
+                tTriggerWaitSamples = (TRIGGER_WAIT_NUMBER_OF_SAMPLES + 1) - i;
+                TRACE_EVENT(TRACE_EVENT_TRIGGER_FOUND, MeasurementControl.TriggerMode);
+            } else if (MeasurementControl.isSingleShotMode) {
+                /*
+                 * End of slice without trigger -> keep status and value for info output and return to main loop
+                 */
+                MeasurementControl.TriggerStatus = tTriggerStatus;
+                MeasurementControl.ValueBeforeTrigger = tUValue.Word;
+                // compensate for the missing millis() ticks of this slice as done at end of acquisition
+                compensateMillisAndEnableTimer2(
+                        (((uint32_t) TRIGGER_WAIT_NUMBER_OF_SAMPLES * ADC_CYCLES_PER_CONVERSION) << MeasurementControl.TimebaseHWValue)
+                                / clockCyclesPerMicrosecond());
+                return;
+            }
         }
     }
 
@@ -956,11 +1406,11 @@ void acquireDataFast(void) {
     uint16_t tValueMax = tUValue.Word;
     uint16_t tValueMin = tUValue.Word;
 
-    uint8_t tIndex = MeasurementControl.TimebaseIndex;
-    uint8_t *DataPointerFast = &DataBufferControl.DataBuffer[0];
+    bool tIsUltraFastMode = MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_ULTRAFAST_MODE;
+    uint8_t *DataPointerFast = DataBufferControl.DataBufferNextInPointer;
     uint16_t tLoopCount = DataBufferControl.AcquisitionSize;
 
-    if (tIndex <= TIMEBASE_INDEX_ULTRAFAST_MODES) {
+    if (tIsUltraFastMode) {
         /*
          * 10-50us range. Data is stored directly as 16 bit value and not processed.
          * => we have only half number of samples (tLoopCount)
@@ -996,10 +1446,10 @@ void acquireDataFast(void) {
             *DataPointerFast++ = tHigh;
         }
         interrupts();
-        DataPointerFast = &DataBufferControl.DataBuffer[0];
+        DataPointerFast = DataBufferControl.DataBufferNextInPointer;
         tUValue.byte.LowByte = *DataPointerFast++;
         tUValue.byte.HighByte = *DataPointerFast++;
-    } // (tIndex <= TIMEBASE_INDEX_ULTRAFAST_MODES)
+    } // (tIsUltraFastMode)
 
     /*
      * Data is processed here.
@@ -1007,7 +1457,7 @@ void acquireDataFast(void) {
      * for ultra fast mode data is read from buffer.
      */
     uint32_t tIntegrateValue = 0;
-    uint8_t *DataPointer = &DataBufferControl.DataBuffer[0]; // ca. 1064 / 0x428
+    uint8_t *DataPointer = DataBufferControl.DataBufferNextInPointer; // ca. 1064 / 0x428
     for (i = tLoopCount; i > 0; --i) {
         /*
          * process (first) value
@@ -1039,7 +1489,7 @@ void acquireDataFast(void) {
         /*
          * get next value. Only for fast mode!
          */
-        if (tIndex > TIMEBASE_INDEX_ULTRAFAST_MODES) {
+        if (!tIsUltraFastMode) {
             // 101-201us range 13 us conversion time
             // get values from ADC
             // wait for free running conversion to finish
@@ -1067,7 +1517,7 @@ void acquireDataFast(void) {
     ADCSRA &= ~_BV(ADATE); // Disable auto-triggering
     MeasurementControl.RawValueMax = tValueMax;
     MeasurementControl.RawValueMin = tValueMin;
-    if (tIndex <= TIMEBASE_INDEX_ULTRAFAST_MODES && tLoopCount > REMOTE_DISPLAY_WIDTH) {
+    if (tIsUltraFastMode && tLoopCount > REMOTE_DISPLAY_WIDTH) {
         // compensate for half sample count in last measurement in ultra fast mode
         tIntegrateValue *= 2;
         // set remaining of buffer to zero
@@ -1076,42 +1526,227 @@ void acquireDataFast(void) {
         }
     }
     MeasurementControl.IntegrateValueForAverage = tIntegrateValue;
+
+    if (tTriggerWaitSamples != 0) {
+        /*
+         * Timer2 overflow interrupt is disabled while waiting, so its overflow count is behind.
+         * Compute the trigger time from the number of conversions since start of waiting.
+         * Doing the division before reading the buffer would delay the first samples.
+         */
+        uint32_t tWaitCycles = ((uint32_t) tTriggerWaitSamples * ADC_CYCLES_PER_CONVERSION) << MeasurementControl.TimebaseHWValue;
+        MeasurementControl.TriggerTimestamp = tWaitStartTimestamp + (tWaitCycles / (clockCyclesPerMicrosecond() * 4));
+        MeasurementControl.TriggerTimestampIsValid = true;
+        sTriggerWaitMicros = tWaitCycles / clockCyclesPerMicrosecond();
+    }
     DataBufferControl.DataBufferFull = true;
+    TRACE_EVENT(TRACE_EVENT_BUFFER_FULL, 0);
 }
 
-// Dummy ISR - only to reset Interrupt flag
+/*
+ * Resets interrupt flag for next ADC auto trigger
+ * and handles the timer0 periods of the microseconds trigger delay
+ */
 ISR(TIMER0_COMPA_vect) {
+    if (MeasurementControl.TriggerDelayTimerIsRunning) {
+        if (MeasurementControl.TriggerDelayTimer0PeriodsRemaining == 0) {
+            /*
+             * End of delay, first conversion was just started by this compare match -> switch timer0 back to timebase.
+             * Second sample is delayed by the latency of this ISR, all following are in phase with the second one.
+             */
+            MeasurementControl.TriggerDelayTimerIsRunning = false;
+            TCCR0B = 0;
+            TCNT0 = 0;
+            OCR0A = MeasurementControl.TimebaseDescriptor.CTCValue - 1;
+            TCCR0B = MeasurementControl.TimebaseDescriptor.Timer0Prescale;
+        } else {
+            OCR0A = 0xFF; // all but the first period have 256 cycles
+            MeasurementControl.TriggerDelayTimer0PeriodsRemaining--;
+            if (MeasurementControl.TriggerDelayTimer0PeriodsRemaining == 0) {
+                // next compare match is end of delay -> enable auto trigger
+                ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIF) | MeasurementControl.TimebaseHWValue | _BV(ADIE);
+            }
+        }
+    }
 }
 
+#ifdef SUPPORT_DATA_LOGGER
 /*
- * Interrupt service routine for adc interrupt
- * used only for "slow" mode >=496us/div because ISR overhead is to much for fast mode
- * app. 7 microseconds + 2 for push + 2 for pop
- * app. 2 microseconds for trigger search + 2 for push + 2 for pop
- * 7 cycles before entering
- * 4 cycles RETI
- * ADC is free running for trigger phase, where ADC runs with PRESCALE16 (as for 496 us range)
- * First value, which mets trigger condition, is taken as first data.
+ * Accumulate value for current data logger channel and switch ADC to next selected channel.
+ * After a reference switch, DATA_LOGGER_REFERENCE_SETTLING_CONVERSIONS conversions of the same channel are discarded
+ * to give 10 ms for settling of the reference.
+ * Called by timer0 compare B ISR, which is only enabled while the logger is running.
  */
-//#define DEBUG_ISR_TIMING
-ISR(ADC_vect) {
-// 7++ for jump to ISR
-    // 3 + 10 pushes (r18 - r31) + in + eor = 28 cycles
-// 35++ cycles to get here
-#ifdef DEBUG_ISR_TIMING
-    digitalWriteFast(DEBUG_PIN, HIGH);
-#endif
+void handleDataLoggerConversion(uint16_t aValue) {
+    if (DataLogger.DiscardSampleCount != 0) {
+        DataLogger.DiscardSampleCount--;
+        return;
+    }
+    uint8_t tIndex = DataLogger.ChannelIndex;
+    DataLoggerChannelStruct * tChannelPtr = &DataLogger.Channels[tIndex];
+    if (aValue < tChannelPtr->Min) {
+        tChannelPtr->Min = aValue;
+    }
+    if (aValue > tChannelPtr->Max) {
+        tChannelPtr->Max = aValue;
+    }
+    tChannelPtr->Sum += aValue;
+    tChannelPtr->Count++;
+
+    /*
+     * Next selected channel. The next conversion is started by the next timer0 compare match, so ADMUX can be changed here.
+     */
+    do {
+        tIndex++;
+        if (tIndex >= ADC_CHANNEL_COUNT) {
+            tIndex = 0;
+        }
+    } while (!(DataLogger.ChannelMask & _BV(tIndex)));
+    if (tIndex != DataLogger.ChannelIndex) {
+        DataLogger.ChannelIndex = tIndex;
+        uint8_t tNewADMUX = DataLogger.ADMUXValues[tIndex];
+        if ((ADMUX ^ tNewADMUX) & (_BV(REFS1) | _BV(REFS0))) {
+            DataLogger.DiscardSampleCount = DATA_LOGGER_REFERENCE_SETTLING_CONVERSIONS;
+        }
+        ADMUX = tNewADMUX;
+    }
+}
 
+/*
+ * Own ISR for the data logger, so the ADC ISR of the DSO needs no check for the logger.
+ * Compare B is in the middle of the timer0 period, when the conversion started by compare A has finished.
+ */
+ISR(TIMER0_COMPB_vect) {
     Myword tUValue;
     tUValue.byte.LowByte = ADCL;
     tUValue.byte.HighByte = ADCH;
+    handleDataLoggerConversion(tUValue.Word);
+}
+#endif
 
-    if (MeasurementControl.TriggerStatus != TRIGGER_STATUS_FOUND) {
-        bool tTriggerFound = false;
-        /*
-         * Trigger detection here
-         */
-        uint8_t tTriggerStatus = MeasurementControl.TriggerStatus;
+/*
+ * ADC conversion complete. Conversions are triggered by timer0 compare match or free running for trigger search.
+ */
+#ifdef MEASURE_ISR_TIMING
+ISR(ADC_vect) {
+    uint8_t tTimer2TicksAtStart = TCNT2;
+    uint8_t tTimer0TicksAtStart = TCNT0;
+    /*
+     * Timer0 restarts at 0 at the compare match which triggers the conversion.
+     * Latency is only measured for timer0 prescaler 8, which gives a resolution of 8 cycles.
+     * A running conversion shows, that the next compare match already happened and TCNT0 has restarted.
+     */
+    bool tIsLatencyMeasurable = MeasurementControl.TriggerStatus == TRIGGER_STATUS_FOUND
+            && MeasurementControl.TimebaseDescriptor.Timer0Prescale == TIMER0_PRESCALE8 && !(ADCSRA & _BV(ADSC));
+    uint16_t tSampleOverrunCountAtStart = MeasurementControl.SampleOverrunCount;
+
+    handleADCInterrupt();
+
+    uint16_t tLatencyCycles = ISR_TIMING_NO_LATENCY;
+    // TCNT0 has restarted as well, if samples were lost
+    if (tIsLatencyMeasurable && MeasurementControl.SampleOverrunCount == tSampleOverrunCountAtStart) {
+        // Conversion complete interrupt is requested 13.5 ADC clocks after the match
+        int16_t tCycles = (tTimer0TicksAtStart * 8) - ((27 << MeasurementControl.TimebaseHWValue) >> 1);
+        if (tCycles < 0) {
+            tCycles = 0;
+        }
+        tLatencyCycles = tCycles;
+    }
+    addISRTiming(ISR_TIMING_ADC, tTimer2TicksAtStart, tLatencyCycles);
+}
+#else
+ISR(ADC_vect) {
+    handleADCInterrupt();
+}
+#endif
+
+/*
+ * Start point for sample overrun detection. Called at start of timer0 triggered acquisition.
+ */
+void setOverrunCheckReference(void) {
+    MeasurementControl.OverrunCheckTimer0Count = TCNT0;
+    MeasurementControl.OverrunCheckTimer2Count = TCNT2;
+    MeasurementControl.OverrunCheckConversionWasRunning = false;
+}
+
+/*
+ * Interrupt service routine for adc interrupt
+ * used only for "slow" mode >=496us/div because ISR overhead is to much for fast mode
+ * app. 7 microseconds + 2 for push + 2 for pop
+ * app. 2 microseconds for trigger search + 2 for push + 2 for pop
+ * 7 cycles before entering
+ * 4 cycles RETI
+ * ADC is free running for trigger phase, where ADC runs with PRESCALE16 (as for 496 us range)
+ * First value, which mets trigger condition, is taken as first data.
+ */
+//#define DEBUG_ISR_TIMING
+void handleADCInterrupt(void) {
+// 7++ for jump to ISR
+    // 3 + 10 pushes (r18 - r31) + in + eor = 28 cycles
+// 35++ cycles to get here
+#ifdef DEBUG_ISR_TIMING
+    digitalWriteFast(DEBUG_PIN, HIGH);
+#endif
+
+    Myword tUValue;
+    tUValue.byte.LowByte = ADCL;
+    tUValue.byte.HighByte = ADCH;
+
+    if (MeasurementControl.TriggerStatus == TRIGGER_STATUS_FOUND && MeasurementControl.OverrunCheckSamplePeriodCycles != 0) {
+        /*
+         * Sample overrun detection. Each timer0 compare match triggers one conversion.
+         * Timer2 gives the time since the last call with a resolution of 64 cycles, TCNT0 gives the exact position
+         * in the sample period. Together they give the number of compare matches since the last call,
+         * independent of the timer0 compare ISR, which may be blocked as well.
+         * ADSC is set, if the conversion of the last compare match is still running.
+         * If more than one conversion finished since the last call, this ISR was delayed by other ISRs
+         * (USART, timer1 waveform) and the older values are overwritten.
+         */
+        uint8_t tTimer0Count = TCNT0;
+        uint8_t tTimer2Count = TCNT2;
+        bool tConversionIsRunning = ADCSRA & _BV(ADSC);
+        uint16_t tSamplePeriodCycles = MeasurementControl.OverrunCheckSamplePeriodCycles;
+        // cycles from last compare match before last call to last compare match before now, plus half a period for rounding
+        uint16_t tCycles = ((uint16_t) (uint8_t) (tTimer2Count - MeasurementControl.OverrunCheckTimer2Count) * 64)
+                + (int16_t) (MeasurementControl.OverrunCheckTimer0Count - tTimer0Count) * MeasurementControl.OverrunCheckTimer0Divider
+                + (tSamplePeriodCycles / 2);
+        /*
+         * With N compare matches counted by the loop below, the finished conversions since last call are:
+         * N conversions started, plus the one still running at last call, minus the one still running now.
+         * One of them is read by this call, all others are lost:
+         * lost = N + WasRunning - IsRunning - 1
+         */
+        int8_t tLostSamples = MeasurementControl.OverrunCheckConversionWasRunning - tConversionIsRunning - 1;
+        // mostly 1 or 2 loops, so no division
+        while (tCycles >= tSamplePeriodCycles) {
+            tCycles -= tSamplePeriodCycles;
+            tLostSamples++;
+        }
+        if (tLostSamples > 0) {
+            MeasurementControl.SampleOverrunCount += tLostSamples;
+            TRACE_EVENT(TRACE_EVENT_SAMPLE_OVERRUN, tLostSamples);
+        }
+        MeasurementControl.OverrunCheckTimer0Count = tTimer0Count;
+        MeasurementControl.OverrunCheckTimer2Count = tTimer2Count;
+        MeasurementControl.OverrunCheckConversionWasRunning = tConversionIsRunning;
+    }
+
+    if (MeasurementControl.TriggerStatus == TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY) {
+        /*
+         * First conversion after microseconds trigger delay, started cycle exact by timer0 compare match,
+         * or by timer2 compare B ISR after milliseconds trigger delay. Take it as first data.
+         */
+        TIMSK2 = 0; // disable timer2 (millis() interrupts to avoid jitter. Enable at main loop on buffer full
+        setOverrunCheckReference();
+        MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND;
+        MeasurementControl.SamplePostscalerCount = 0;
+        MeasurementControl.ValueMaxForISR = tUValue.Word;
+        MeasurementControl.ValueMinForISR = tUValue.Word;
+    } else if (MeasurementControl.TriggerStatus != TRIGGER_STATUS_FOUND) {
+        bool tTriggerFound = false;
+        /*
+         * Trigger detection here
+         */
+        uint8_t tTriggerStatus = MeasurementControl.TriggerStatus;
 
         if (MeasurementControl.TriggerSlopeRising) {
             if (tTriggerStatus == TRIGGER_STATUS_START) {
@@ -1170,35 +1805,26 @@ ISR(ADC_vect) {
             }
         } else {
             /*
-             * Trigger found (or timeout reached) , check for delay
+             * Trigger found (or timeout reached) , take timestamp and check for delay
              */
+            MeasurementControl.TriggerTimestamp = getTimer2Timestamp();
+            MeasurementControl.TriggerTimestampIsValid = true;
+            TRACE_EVENT(TRACE_EVENT_TRIGGER_FOUND, MeasurementControl.TriggerMode);
             if (MeasurementControl.TriggerDelayMode != TRIGGER_DELAY_NONE) {
                 if (MeasurementControl.TriggerDelayMode == TRIGGER_DELAY_MICROS) {
-                    TIMSK2 = 0; // disable timer2 (millis()) interrupt to avoid jitter
-                    // enable RX interrupt for GUI, otherwise we could miss input bytes at long delays (eg.50000us)
-                    uint16_t tDelayMicros = MeasurementControl.TriggerDelayMillisOrMicros;
-                    // delayMicroseconds(tDelayMicros); substituted by code below, to avoid additional register pushes
-                    asm volatile (
-                            "1: sbiw %0,1" "\n\t" // 2 cycles
-                            "1: adiw %0,1" "\n\t"// 2 cycles
-                            "1: sbiw %0,1" "\n\t"// 2 cycles
-                            "1: adiw %0,1" "\n\t"// 2 cycles
-                            "1: sbiw %0,1" "\n\t"// 2 cycles
-                            "1: adiw %0,1" "\n\t"// 2 cycles
-                            "1: sbiw %0,1" "\n\t"// 2 cycles
-                            "brne .-16" : : "w" (tDelayMicros)// 16 cycles
-                    );
-
-                    TIMSK2 = _BV(TOIE2); // Enable overflow interrupts which replaces the Arduino millis() interrupt
-                    // get a new value since ADC is already free running here
-                    tUValue.byte.LowByte = ADCL;
-                    tUValue.byte.HighByte = ADCH;
+                    // No busy waiting here, timer0 compare match at end of delay starts acquisition
+                    startTriggerDelayTimer(MeasurementControl.TriggerDelayMillisOrMicros);
+#ifdef DEBUG_ISR_TIMING
+                    digitalWriteFast(DEBUG_PIN, LOW);
+#endif
+                    return;
                 } else {
-                    // needs additional register pushes
-                    // MeasurementControl.TriggerDelayMillisEnd = millis() + MeasurementControl.TriggerDelayMillisOrMicros;
-                    MeasurementControl.TriggerDelayMillisEnd = 0; // signal main loop to initialize value
+                    ADCSRA = _BV(ADEN) | _BV(ADIF); // stop ADC -> timer2 compare B ISR will restart it at end of delay
                     MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY;
-                    ADCSRA &= ~_BV(ADIE); // disable ADC interrupt -> Main loop will handle delay
+                    startTimer2MillisCountdown(MeasurementControl.TriggerDelayMillisOrMicros);
+#ifdef DEBUG_ISR_TIMING
+                    digitalWriteFast(DEBUG_PIN, LOW);
+#endif
                     return;
                 }
             }
@@ -1228,6 +1854,7 @@ ISR(ADC_vect) {
 
         // 11 clock cycles
         MeasurementControl.TriggerStatus = TRIGGER_STATUS_FOUND;
+        MeasurementControl.SamplePostscalerCount = 0;
         MeasurementControl.ValueMaxForISR = tUValue.Word;
         MeasurementControl.ValueMinForISR = tUValue.Word;
 
@@ -1235,6 +1862,7 @@ ISR(ADC_vect) {
         // set timer to initial state
         TCNT0 = 0; // 1 cycle
         TIFR0 = _BV(OCF0A); // reset int flag. 1 cycle
+        setOverrunCheckReference();
 
         // No need to wait for last self triggered conversion to end
 //        while (bit_is_clear(ADCSRA, ADIF)) {
@@ -1244,18 +1872,16 @@ ISR(ADC_vect) {
         /*
          * variable delay
          */
-        if (MeasurementControl.TimebaseIndex < 6) {
+        uint8_t tFirstSampleDelay4Micros = MeasurementControl.TimebaseDescriptor.FirstSampleDelay4Micros;
+        if (tFirstSampleDelay4Micros == 0) {
             // start new conversion
             ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADSC) | _BV(ADIF) | MeasurementControl.TimebaseHWValue | _BV(ADIE);
             // proceed and take trigger value as first data, since the interrupt request of conversion above is cancelled.
-        } else if (MeasurementControl.TimebaseIndex < 8) {
-            uint16_t a4Microseconds = 15 * 4;
+        } else if (tFirstSampleDelay4Micros != TIMEBASE_FIRST_SAMPLE_SKIP) {
             /*
-             * wait 15 micros for TimebaseIndex == 6 and 47 for TimebaseIndex == 7
+             * wait 15 micros for 1 ms range and 47 for 2 ms range
              */
-            if (MeasurementControl.TimebaseIndex == 7) {
-                a4Microseconds = 47 * 4;
-            }
+            uint16_t a4Microseconds = tFirstSampleDelay4Micros;
             // the following loop takes 4 cycles (1/4 microseconds  at 16 MHz) per iteration
             __asm__ __volatile__ (
                     "1: sbiw %0,1" "\n\t"    // 2 cycles
@@ -1263,6 +1889,7 @@ ISR(ADC_vect) {
             );
             TCNT0 = 0; // 1 cycle
             TIFR0 = _BV(OCF0A); // reset int flag. 1 cycle
+            setOverrunCheckReference();
             // start new conversion
             ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADSC) | _BV(ADIF) | MeasurementControl.TimebaseHWValue | _BV(ADIE);
         } else {
@@ -1280,6 +1907,15 @@ ISR(ADC_vect) {
 
         ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADSC) | _BV(ADIF) | MeasurementControl.TimebaseHWValue | _BV(ADIE);
         // proceed and take trigger value as first data, since the interrupt request of conversion above is cancelled.
+    } else if (MeasurementControl.SamplePostscalerCount != 0) {
+        /*
+         * Software postscaler for timebases slower than timer0 can generate -> skip this sample
+         */
+        MeasurementControl.SamplePostscalerCount--;
+#ifdef DEBUG_ISR_TIMING
+        digitalWriteFast(DEBUG_PIN, LOW);
+#endif
+        return;
     }
 
     /*
@@ -1323,18 +1959,41 @@ ISR(ADC_vect) {
     /***************************************************
      * transform 10 bit value in order to fit on screen
      ***************************************************/
+#ifdef ISR_STATE_IN_GPIOR
+    Myword tOffsetValue;
+    tOffsetValue.byte.LowByte = GPIOR1;
+    tOffsetValue.byte.HighByte = GPIOR2;
+    if (tUValue.Word < tOffsetValue.Word) {
+        tUValue.Word = 0;
+    } else {
+        tUValue.Word = tUValue.Word - tOffsetValue.Word;
+    }
+    /*
+     * Fixed shifts selected by single bit tests, since a shift by a variable count compiles to a loop.
+     * GPIOR0 is in the bit addressable I/O range, so each test is one sbis instruction.
+     * About 8 cycles for shift 2 instead of about 14 for the loop.
+     */
+    if (GPIOR0 & _BV(1)) {
+        tUValue.Word = tUValue.Word >> 2;
+    }
+    if (GPIOR0 & _BV(0)) {
+        tUValue.Word = tUValue.Word >> 1;
+    }
+#else
     if (tUValue.Word < MeasurementControl.OffsetValue) {
         tUValue.Word = 0;
     } else {
         tUValue.Word = tUValue.Word - MeasurementControl.OffsetValue;
     }
     tUValue.Word = tUValue.Word >> MeasurementControl.ShiftValue;
+#endif
     // Byte overflow? This can happen if autorange is disabled.
     if (tUValue.byte.HighByte > 0) {
         tUValue.byte.LowByte = 0xFF;
     }
     // store display byte value
     *tDataBufferPointer++ = DISPLAY_VALUE_FOR_ZERO - tUValue.byte.LowByte;
+    MeasurementControl.SamplePostscalerCount = MeasurementControl.TimebaseDescriptor.SamplePostscaler - 1;
     // detect end of buffer
     if (tDataBufferPointer > DataBufferControl.DataBufferEndPointer) {
         // stop acquisition
@@ -1348,6 +2007,7 @@ ISR(ADC_vect) {
          * Main loop is responsible to start a new acquisition via call of startAcquisition();
          */
         DataBufferControl.DataBufferFull = true;
+        TRACE_EVENT(TRACE_EVENT_BUFFER_FULL, 0);
     }
     DataBufferControl.DataBufferNextInPointer = tDataBufferPointer;
 
@@ -1369,16 +2029,19 @@ ISR(ADC_vect) {
  * VCC
  */
 void setInputRange(uint8_t aShiftValue, uint8_t aActiveAttenuatorValue) {
+    TRACE_EVENT(TRACE_EVENT_RANGE_CHANGE, aShiftValue);
     MeasurementControl.ShiftValue = aShiftValue;
     if (MeasurementControl.ChannelHasActiveAttenuator) {
         setAttenuator(aActiveAttenuatorValue);
     }
     resetOffset();
 
+#ifndef USE_REMOTE_LAYERS
     if (MeasurementControl.isRunning && DisplayControl.DisplayPage == DISPLAY_PAGE_CHART) {
         //clear old grid, since it will be changed
         BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
     }
+#endif
     float tNewGridVoltage;
     uint16_t tHorizontalGridSizeShift8;
 
@@ -1557,7 +2220,9 @@ void computeAutoOffset(void) {
     }
     if (abs(MeasurementControl.OffsetGridCount - tNumberOfGridLinesToSkip) > 1) {
         // avoid jitter by not changing number if its delta is only 1
+#ifndef USE_REMOTE_LAYERS
         BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
+#endif
         MeasurementControl.OffsetValue = tNumberOfGridLinesToSkip * tRawValuePerGrid;
         MeasurementControl.OffsetGridCount = tNumberOfGridLinesToSkip;
         drawGridLinesWithHorizLabelsAndTriggerLine();
@@ -1565,6 +2230,9 @@ void computeAutoOffset(void) {
         MeasurementControl.OffsetValue = 0;
         MeasurementControl.OffsetGridCount = 0;
     }
+#ifdef ISR_STATE_IN_GPIOR
+    loadISRStateRegisters();
+#endif
 }
 
 /*
@@ -1583,8 +2251,27 @@ void resetOffset(void) {
     } else if (MeasurementControl.OffsetMode != OFFSET_MODE_AUTOMATIC) {
         MeasurementControl.OffsetValue = 0;
     }
+#ifdef ISR_STATE_IN_GPIOR
+    // setInputRange() changes ShiftValue before calling this
+    loadISRStateRegisters();
+#endif
 }
 
+#ifdef ISR_STATE_IN_GPIOR
+/*
+ * Copy ISR parameters to general purpose I/O registers.
+ * Must be called after each change of ShiftValue or OffsetValue, since range and offset may change during a running acquisition.
+ */
+void loadISRStateRegisters(void) {
+    uint8_t tSREG = SREG;
+    cli(); // ISR must not see a half written offset
+    GPIOR0 = MeasurementControl.ShiftValue;
+    GPIOR1 = MeasurementControl.OffsetValue;
+    GPIOR2 = MeasurementControl.OffsetValue >> 8;
+    SREG = tSREG;
+}
+#endif
+
 /***********************************************************************
  * Attenuator support stuff
  ***********************************************************************/
@@ -1607,6 +2294,181 @@ uint16_t getAttenuatorFactor(void) {
     return tRetValue;
 }
 
+#ifdef SUPPORT_DATA_LOGGER
+/************************************************************************
+ * Data logger section
+ ************************************************************************/
+/*
+ * Channel references are the same as for DSO acquisition, except for VRef channel, which is measured against VCC
+ * and can be used to compute VCC.
+ * Timer0 triggers a conversion every 5 ms, the DSO timebase is restored at stop.
+ */
+static uint8_t sADMUXBeforeDataLogger;
+void startDataLogger(void) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; ++i) {
+        uint8_t tChannel = i;
+        uint8_t tReference = DEFAULT;
+        if (i == MAX_ADC_EXTERNAL_CHANNEL + 1) {
+            tChannel = ADC_TEMPERATURE_CHANNEL;
+            tReference = INTERNAL;
+        } else if (i == MAX_ADC_EXTERNAL_CHANNEL + 2) {
+            tChannel = ADC_1_1_VOLT_CHANNEL;
+        } else if (MeasurementControl.AttenuatorType == ATTENUATOR_TYPE_FIXED_ATTENUATOR
+                && i < NUMBER_OF_CHANNELS_WITH_FIXED_ATTENUATOR) {
+            tReference = INTERNAL;
+        }
+        DataLogger.ADMUXValues[i] = tChannel | (tReference << REFS0);
+        resetDataLoggerChannel(i);
+    }
+
+    uint8_t tIndex = 0;
+    while (!(DataLogger.ChannelMask & _BV(tIndex))) {
+        tIndex++;
+    }
+    DataLogger.ChannelIndex = tIndex;
+    DataLogger.DiscardSampleCount = DATA_LOGGER_REFERENCE_SETTLING_CONVERSIONS;
+    sADMUXBeforeDataLogger = ADMUX;
+    ADMUX = DataLogger.ADMUXValues[tIndex];
+
+    DataLogger.RecordNumber = 0;
+    DataLogger.MillisOfLastRecord = millis();
+    DataLogger.isRunning = true;
+
+    // timer0 is in CTC mode, its compare match starts the conversions
+    TCCR0B = 0;
+    TCNT0 = 0;
+    OCR0A = DATA_LOGGER_CTC_VALUE - 1;
+    OCR0B = DATA_LOGGER_READ_COMPARE_VALUE;
+    ADCSRB = _BV(ADTS0) | _BV(ADTS1); // Trigger source Timer/Counter0 Compare Match A
+    TIFR0 = _BV(OCF0A) | _BV(OCF0B);
+    // No ADC interrupt, the result is read by timer0 compare B ISR
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIF) | ADC_PRESCALE128;
+    TIMSK0 = _BV(OCIE0A) | _BV(OCIE0B);
+    TCCR0B = DATA_LOGGER_TIMER0_PRESCALE;
+}
+
+void stopDataLogger(void) {
+    ADCSRA = _BV(ADEN) | _BV(ADIF); // stop auto trigger
+    TIMSK0 = _BV(OCIE0A); // disable compare B interrupt of logger
+    DataLogger.isRunning = false;
+    ADMUX = sADMUXBeforeDataLogger;
+    TCCR0B = MeasurementControl.TimebaseDescriptor.Timer0Prescale;
+    OCR0A = MeasurementControl.TimebaseDescriptor.CTCValue - 1;
+}
+
+/*
+ * Also called while logger ISR is running, so disable interrupts
+ */
+void resetDataLoggerChannel(uint8_t aChannelIndex) {
+    DataLoggerChannelStruct * tChannelPtr = &DataLogger.Channels[aChannelIndex];
+    cli();
+    tChannelPtr->Min = __UINT16_MAX__;
+    tChannelPtr->Max = 0;
+    tChannelPtr->Sum = 0;
+    tChannelPtr->Count = 0;
+    sei();
+}
+
+/*
+ * At end of each interval get min/avg/max of selected channels, send them as binary records to host and print them.
+ * Without USE_REMOTE_DATA_RECORDS they are only printed.
+ * A channel without conversions in this interval has min > max.
+ */
+void loopDataLogger(void) {
+    uint32_t tIntervalMillis = DataLogger.IntervalSeconds * 1000L;
+    if (millis() - DataLogger.MillisOfLastRecord >= tIntervalMillis) {
+        DataLogger.MillisOfLastRecord += tIntervalMillis;
+
+        DataLoggerRecordStruct tRecords[ADC_CHANNEL_COUNT];
+        uint8_t tNumberOfRecords = 0;
+        for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; ++i) {
+            if (DataLogger.ChannelMask & _BV(i)) {
+                cli();
+                DataLoggerChannelStruct tChannel = DataLogger.Channels[i];
+                resetDataLoggerChannel(i); // enables interrupts again
+
+                DataLoggerRecordStruct * tRecordPtr = &tRecords[tNumberOfRecords++];
+                tRecordPtr->ChannelIndex = i;
+                tRecordPtr->ADMUXValue = DataLogger.ADMUXValues[i];
+                tRecordPtr->Min = tChannel.Min;
+                tRecordPtr->Max = tChannel.Max;
+                tRecordPtr->Average = 0;
+                if (tChannel.Count != 0) {
+                    tRecordPtr->Average = (tChannel.Sum + (tChannel.Count / 2)) / tChannel.Count;
+                }
+            }
+        }
+        DataLogger.RecordNumber++;
+#ifdef USE_REMOTE_DATA_RECORDS
+        BlueDisplay1.writeDataRecord(DATA_LOGGER_RECORD_TYPE_MIN_AVERAGE_MAX, DataLogger.RecordNumber, (uint8_t*) &tRecords[0],
+                tNumberOfRecords * sizeof(DataLoggerRecordStruct));
+#endif
+        if (DisplayControl.DisplayPage == DISPLAY_PAGE_DATA_LOGGER) {
+            printDataLoggerValues(&tRecords[0], tNumberOfRecords);
+        }
+    }
+}
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+/************************************************************************
+ * Trend recorder section
+ ************************************************************************/
+/*
+ * The buffer is only cleared at setup and by the Clear button, so its content is kept if the BlueDisplay app reconnects.
+ */
+void clearTrendRecorder(void) {
+    TrendRecorder.NextIndex = 0;
+    TrendRecorder.Count = 0;
+    TrendRecorder.AcquisitionCount = 0;
+}
+
+/*
+ * Called for each acquisition in running mode.
+ * Accumulates min, max and average and appends an entry to the buffer at end of interval.
+ * The interval starts with its first acquisition, so time while stopped is not included.
+ */
+void addTrendValues(void) {
+    if (TrendRecorder.AcquisitionCount == 0) {
+        TrendRecorder.MillisOfIntervalStart = millis();
+        TrendRecorder.RawMin = MeasurementControl.RawValueMin;
+        TrendRecorder.RawMax = MeasurementControl.RawValueMax;
+        TrendRecorder.AverageSum = 0;
+    }
+    if (TrendRecorder.RawMin > MeasurementControl.RawValueMin) {
+        TrendRecorder.RawMin = MeasurementControl.RawValueMin;
+    }
+    if (TrendRecorder.RawMax < MeasurementControl.RawValueMax) {
+        TrendRecorder.RawMax = MeasurementControl.RawValueMax;
+    }
+    TrendRecorder.AverageSum += MeasurementControl.ValueAverage;
+    TrendRecorder.AcquisitionCount++;
+
+    if (millis() - TrendRecorder.MillisOfIntervalStart >= TrendRecorder.IntervalSeconds * 1000L) {
+        TrendEntryStruct * tEntryPtr = &TrendRecorder.Buffer[TrendRecorder.NextIndex];
+        tEntryPtr->Min = TrendRecorder.RawMin >> 2;
+        tEntryPtr->Max = TrendRecorder.RawMax >> 2;
+        tEntryPtr->Average = (TrendRecorder.AverageSum / TrendRecorder.AcquisitionCount) >> 2;
+        // frequency of last acquisition of interval
+        computePeriodFrequency();
+        uint32_t tFrequency = MeasurementControl.FrequencyHertz;
+        if (tFrequency > 0xFFFF) {
+            tFrequency = 0xFFFF;
+        }
+        tEntryPtr->FrequencyHertz = tFrequency;
+
+        TrendRecorder.NextIndex++;
+        if (TrendRecorder.NextIndex >= TREND_BUFFER_SIZE) {
+            TrendRecorder.NextIndex = 0;
+        }
+        if (TrendRecorder.Count < TREND_BUFFER_SIZE) {
+            TrendRecorder.Count++;
+        }
+        TrendRecorder.AcquisitionCount = 0;
+    }
+}
+#endif
+
 /************************************************************************
  * BUTTON handler section
  ************************************************************************/
@@ -1644,6 +2506,56 @@ void doSetTriggerDelay(float aValue) {
     setTriggerDelayCaption();
 }
 
+/*
+ * 0 or no input switches back to the fixed timebase
+ */
+void doSetSamplePeriod(float aValue) {
+    if (aValue != NUMBER_INITIAL_VALUE_DO_NOT_SHOW && aValue >= 1) {
+        uint32_t tSamplePeriodMicros = USER_SAMPLE_PERIOD_MICROS_MAX;
+        if (aValue < USER_SAMPLE_PERIOD_MICROS_MAX) {
+            tSamplePeriodMicros = aValue;
+        }
+        setUserSamplePeriod(tSamplePeriodMicros);
+    } else {
+        changeTimeBaseValue(0);
+    }
+    setSamplePeriodButtonCaption();
+}
+
+#ifdef SUPPORT_DATA_LOGGER
+/*
+ * 0 or no input restores the default interval
+ */
+void doSetDataLoggerInterval(float aValue) {
+    uint16_t tIntervalSeconds = DATA_LOGGER_INTERVAL_SECONDS_DEFAULT;
+    if (aValue != NUMBER_INITIAL_VALUE_DO_NOT_SHOW && aValue >= 1) {
+        tIntervalSeconds = DATA_LOGGER_INTERVAL_SECONDS_MAX;
+        if (aValue < DATA_LOGGER_INTERVAL_SECONDS_MAX) {
+            tIntervalSeconds = aValue;
+        }
+    }
+    DataLogger.IntervalSeconds = tIntervalSeconds;
+    setDataLoggerIntervalButtonCaption();
+}
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+/*
+ * 0 or no input restores the default interval. Entries already recorded are kept.
+ */
+void doSetTrendInterval(float aValue) {
+    uint16_t tIntervalSeconds = TREND_INTERVAL_SECONDS_DEFAULT;
+    if (aValue != NUMBER_INITIAL_VALUE_DO_NOT_SHOW && aValue >= 1) {
+        tIntervalSeconds = TREND_INTERVAL_SECONDS_MAX;
+        if (aValue < TREND_INTERVAL_SECONDS_MAX) {
+            tIntervalSeconds = aValue;
+        }
+    }
+    TrendRecorder.IntervalSeconds = tIntervalSeconds;
+    setTrendIntervalButtonCaption();
+}
+#endif
+
 /*
  * toggle between 5 and 1.1 volt reference
  */
@@ -1670,13 +2582,18 @@ void doStartStopDSO(__attribute__((unused))  BDButton * aTheTouchedButton, __att
          * Do this asynchronously to the interrupt routine by "StopRequested" in order to extend a running or started acquisition.
          * Stopping does not need to release the trigger condition except for TRIGGER_MODE_EXTERN since trigger always has a timeout.
          * Stop single shot mode by switching to regular mode (and then waiting for timeout)
+         * Stop sequence after actual shot, which keeps its size.
          */
-        DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+        if (MeasurementControl.SequenceNumberOfShots != 0) {
+            MeasurementControl.SequenceNumberOfShots = MeasurementControl.SequenceShotIndex + 1;
+        } else {
+            DataBufferControl.DataBufferEndPointer = &DataBufferControl.DataBuffer[DATABUFFER_SIZE - 1];
+        }
 
         // - use noInterrupts() to avoid race conditions
         noInterrupts();
         if (MeasurementControl.TriggerStatus != TRIGGER_STATUS_FOUND) {
-            if (MeasurementControl.TriggerMode == TRIGGER_MODE_EXTERN) {
+            if (MeasurementControl.TriggerMode == TRIGGER_MODE_EXTERN && !MeasurementControl.AcquisitionFastMode) {
                 // Call the external trigger event routine by software for TRIGGER_MODE_EXTERN to start reading data.
                 INT0_vect();
             } else if (MeasurementControl.TriggerMode == TRIGGER_MODE_MANUAL || MeasurementControl.isSingleShotMode) {
@@ -1697,8 +2614,10 @@ void doStartStopDSO(__attribute__((unused))  BDButton * aTheTouchedButton, __att
         }
         // return to continuous mode with stop requested
         MeasurementControl.StopRequested = true;
-        // AcquisitionSize is used in synchronous fast loop so we can set it here
-        DataBufferControl.AcquisitionSize = DATABUFFER_SIZE;
+        if (MeasurementControl.SequenceNumberOfShots == 0) {
+            // AcquisitionSize is used in synchronous fast loop so we can set it here
+            DataBufferControl.AcquisitionSize = DATABUFFER_SIZE;
+        }
         DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
         // no feedback tone, it kills the timing!
     } else {
@@ -1711,6 +2630,8 @@ void doStartStopDSO(__attribute__((unused))  BDButton * aTheTouchedButton, __att
         activateChartGui();
         drawGridLinesWithHorizLabelsAndTriggerLine();
         MeasurementControl.isSingleShotMode = false;
+        MeasurementControl.SequenceNumberOfShots = 0;
+        resetTriggerStatistics();
         startAcquisition();
         MeasurementControl.isRunning = true;
     }
@@ -1727,6 +2648,27 @@ uint8_t scrollChart(int aScrollAmount) {
         return true;
     }
     bool isError = false;
+    if (!MeasurementControl.isRunning && MeasurementControl.SequenceNumberOfShots > 1) {
+        /*
+         * Flip to next or previous shot of sequence
+         */
+        if (aScrollAmount > 0) {
+            if (MeasurementControl.SequenceShotIndex + 1 < MeasurementControl.SequenceNumberOfShots) {
+                MeasurementControl.SequenceShotIndex++;
+            } else {
+                isError = true;
+            }
+        } else if (MeasurementControl.SequenceShotIndex > 0) {
+            MeasurementControl.SequenceShotIndex--;
+        } else {
+            isError = true;
+        }
+        DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[MeasurementControl.SequenceShotIndex
+                * REMOTE_DISPLAY_WIDTH];
+        drawDataBuffer(DataBufferControl.DataBufferDisplayStart, COLOR_DATA_HOLD, COLOR_BACKGROUND_DSO);
+        printSingleshotMarker();
+        return isError;
+    }
     /*
      * set start of display in data buffer
      */
@@ -1737,7 +2679,7 @@ uint8_t scrollChart(int aScrollAmount) {
         isError = true;
     } else {
         uint8_t * tMaxAddress = &DataBufferControl.DataBuffer[DATABUFFER_SIZE];
-        if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_FAST_MODES) {
+        if (MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_FAST_MODE) {
             // Only half of data buffer is filled
             tMaxAddress = &DataBufferControl.DataBuffer[DATABUFFER_SIZE / 2];
         }
@@ -1752,25 +2694,137 @@ uint8_t scrollChart(int aScrollAmount) {
     return isError;
 }
 
-void drawDataBuffer(uint8_t *aByteBuffer, uint16_t aColor, uint16_t aClearBeforeColor) {
+/*
+ * Returns pointer to the REMOTE_DISPLAY_WIDTH display values for aByteBuffer.
+ * For XScale > 1 these are computed in DisplayBuffer, otherwise it is aByteBuffer itself.
+ */
+uint8_t * expandDataBuffer(uint8_t *aByteBuffer) {
     uint8_t tXScale = DisplayControl.XScale;
     uint8_t * tBufferPtr = aByteBuffer;
     if (tXScale > 1) {
-        // expand - show value several times
+        /*
+         * expand - linear interpolation between two samples with 7 bit fixed point values.
+         * Only one division per sample, the values in between are computed by addition.
+         */
         uint8_t * tDisplayBufferPtr = &DataBufferControl.DisplayBuffer[0];
-        uint8_t tXScaleCounter = tXScale;
-        uint8_t tValue = *tBufferPtr++;
-        for (uint16_t i = 0; i < sizeof(DataBufferControl.DisplayBuffer); ++i) {
-            if (tXScaleCounter == 0) {
-                tValue = *tBufferPtr++;
-                tXScaleCounter = tXScale;
+        uint16_t tNumberOfSamples = sizeof(DataBufferControl.DisplayBuffer) / tXScale;
+        uint8_t tNextValue = *tBufferPtr++;
+        for (uint16_t i = 0; i < tNumberOfSamples; ++i) {
+            uint8_t tValue = tNextValue;
+            int16_t tDelta = 0;
+            // last sample has no successor on screen and is only repeated
+            if (i < tNumberOfSamples - 1) {
+                tNextValue = *tBufferPtr++;
+                tDelta = ((int16_t) (tNextValue - tValue) << 7) / tXScale;
+            }
+            int16_t tFixedPointValue = (tValue << 7) + (1 << 6); // + 0.5 for rounding
+            for (uint8_t j = 0; j < tXScale; ++j) {
+                *tDisplayBufferPtr++ = tFixedPointValue >> 7;
+                tFixedPointValue += tDelta;
             }
-            tXScaleCounter--;
-            *tDisplayBufferPtr++ = tValue;
         }
         tBufferPtr = &DataBufferControl.DisplayBuffer[0];
     }
-    BlueDisplay1.drawChartByteBuffer(0, 0, aColor, aClearBeforeColor, tBufferPtr, sizeof(DataBufferControl.DisplayBuffer));
+    return tBufferPtr;
+}
+
+void drawDataBuffer(uint8_t *aByteBuffer, uint16_t aColor, uint16_t aClearBeforeColor) {
+#ifdef USE_REMOTE_CHART_X_STEP
+    uint8_t tXScale = DisplayControl.XScale;
+    if (tXScale > 1) {
+        // send only the real samples, the app connects them by lines
+        BlueDisplay1.drawChartByteBufferWithXStep(0, 0, tXScale, aColor, aClearBeforeColor, aByteBuffer,
+                sizeof(DataBufferControl.DisplayBuffer) / tXScale);
+        return;
+    }
+#endif
+    BlueDisplay1.drawChartByteBuffer(0, 0, aColor, aClearBeforeColor, expandDataBuffer(aByteBuffer),
+            sizeof(DataBufferControl.DisplayBuffer));
+}
+
+/*
+ * Store the displayed values of the analyze mode chart in EEPROM.
+ * Writing all values takes up to 1 second, so they are written in chunks by LOOP_TASK_STORE_REFERENCE.
+ * The chunks are computed from DataBuffer, which is only overwritten by startAcquisition() and clearDataBuffer().
+ * Returns false if running, since then DataBuffer is overwritten by the acquisition.
+ */
+bool storeReference(uint8_t aSlot) {
+    if (MeasurementControl.isRunning) {
+        return false;
+    }
+    completeReferenceStore();
+    DisplayControl.ReferenceStoreSlot = aSlot;
+    DisplayControl.ReferenceStoreIndex = 0;
+    DisplayControl.ReferenceStoreSource = DataBufferControl.DataBufferDisplayStart;
+    DisplayControl.ReferenceStoreXScale = DisplayControl.XScale;
+    LoopTaskControl.PendingMask |= _BV(LOOP_TASK_STORE_REFERENCE);
+    return true;
+}
+
+/*
+ * Computes the next REFERENCE_STORE_CHUNK_SIZE display values from DataBuffer and writes them to EEPROM.
+ * For XScale > 1 the values are interpolated with the same fixed point arithmetic as in expandDataBuffer().
+ * Returns true if the last chunk was written
+ */
+bool storeReferenceChunk(void) {
+    uint8_t tChunk[REFERENCE_STORE_CHUNK_SIZE];
+    uint16_t tIndex = DisplayControl.ReferenceStoreIndex;
+    uint8_t tXScale = DisplayControl.ReferenceStoreXScale;
+    uint16_t tNumberOfSamples = REMOTE_DISPLAY_WIDTH / tXScale;
+    for (uint8_t i = 0; i < REFERENCE_STORE_CHUNK_SIZE; ++i) {
+        uint16_t tSampleIndex = (tIndex + i) / tXScale;
+        uint8_t tStep = (tIndex + i) - (tSampleIndex * tXScale);
+        uint8_t * tSamplePtr = DisplayControl.ReferenceStoreSource + tSampleIndex;
+        uint8_t tValue = *tSamplePtr;
+        int16_t tDelta = 0;
+        if (tSampleIndex < tNumberOfSamples - 1) {
+            tDelta = ((int16_t) (*(tSamplePtr + 1) - tValue) << 7) / tXScale;
+        }
+        tChunk[i] = ((tValue << 7) + (1 << 6) + (tStep * tDelta)) >> 7;
+    }
+    eeprom_update_block(tChunk, &ReferenceSlots[DisplayControl.ReferenceStoreSlot][tIndex], REFERENCE_STORE_CHUNK_SIZE);
+    tIndex += REFERENCE_STORE_CHUNK_SIZE;
+    DisplayControl.ReferenceStoreIndex = tIndex;
+    return (tIndex >= REMOTE_DISPLAY_WIDTH);
+}
+
+/*
+ * Writes the remaining chunks of a pending store. Must be called before DataBuffer is overwritten.
+ */
+void completeReferenceStore(void) {
+    if (LoopTaskControl.PendingMask & _BV(LOOP_TASK_STORE_REFERENCE)) {
+        LoopTaskControl.PendingMask &= ~_BV(LOOP_TASK_STORE_REFERENCE);
+        while (!storeReferenceChunk()) {
+            ;
+        }
+    }
+}
+
+/*
+ * Draw all selected references as overlay without clearing.
+ * Values are read from EEPROM in chunks, so DisplayBuffer, which holds the drawn values in draw while acquire mode, is not touched.
+ * Each chunk has its own chart index, so the remote side keeps all chunks and does not take them as last DSO chart to be cleared.
+ */
+static_assert(REFERENCE_CHART_INDEX_FIRST + (REFERENCE_SLOT_COUNT * REFERENCE_DRAW_CHUNKS_PER_SLOT) <= 0x10,
+        "Chart index of reference chunks does not fit in 4 bits");
+void drawReferenceCharts(void) {
+    uint8_t tChunk[REFERENCE_DRAW_CHUNK_SIZE];
+    uint8_t tChartIndex = REFERENCE_CHART_INDEX_FIRST;
+    for (uint8_t i = 0; i < REFERENCE_SLOT_COUNT; ++i) {
+        if (DisplayControl.ReferenceShowMask & _BV(i)) {
+            uint16_t tColor = pgm_read_word(&ReferenceColors[i]);
+            for (uint16_t tXPos = 0; tXPos < REMOTE_DISPLAY_WIDTH - 1; tXPos += REFERENCE_DRAW_CHUNK_SIZE - 1) {
+                uint8_t tLength = REFERENCE_DRAW_CHUNK_SIZE;
+                if (tXPos + tLength > REMOTE_DISPLAY_WIDTH) {
+                    tLength = REMOTE_DISPLAY_WIDTH - tXPos;
+                }
+                eeprom_read_block(tChunk, &ReferenceSlots[i][tXPos], tLength);
+                BlueDisplay1.drawChartByteBuffer(tXPos, 0, tColor, COLOR_NO_BACKGROUND, tChartIndex++, true, tChunk, tLength);
+            }
+        } else {
+            tChartIndex += REFERENCE_DRAW_CHUNKS_PER_SLOT;
+        }
+    }
 }
 
 void clearDisplayedChart(uint8_t * aDisplayBufferPtr) {
@@ -1778,8 +2832,89 @@ void clearDisplayedChart(uint8_t * aDisplayBufferPtr) {
             sizeof(DataBufferControl.DisplayBuffer));
 }
 
+#ifdef SUPPORT_TREND_RECORDER
+/*
+ * Draw min, average and max values of trend buffer as 3 charts, oldest entry left. Uses DisplayBuffer.
+ * If there are more entries than display width, each group of entries is reduced to one pixel
+ * by taking the minimum of min, the average of average and the maximum of max values.
+ * If there are less entries, each entry is expanded to several pixels.
+ */
+#define TREND_INFO_Y (SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_ASCEND)
+void drawTrendChart(void) {
+    uint16_t tCount = TrendRecorder.Count;
+    if (tCount == 0) {
+        BlueDisplay1.drawText(0, TREND_INFO_Y, F("No trend data"), TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+        return;
+    }
+    uint8_t tDecimation = (tCount + (REMOTE_DISPLAY_WIDTH - 1)) / REMOTE_DISPLAY_WIDTH;
+    uint16_t tNumberOfPixels = tCount / tDecimation;
+    uint8_t tExpansion = REMOTE_DISPLAY_WIDTH / tNumberOfPixels;
+    // index of oldest entry to show
+    uint16_t tStartIndex = TrendRecorder.NextIndex + TREND_BUFFER_SIZE - (tNumberOfPixels * tDecimation);
+    if (tStartIndex >= TREND_BUFFER_SIZE) {
+        tStartIndex -= TREND_BUFFER_SIZE;
+    }
+
+    const uint16_t tColors[3] = { COLOR_MAX_MIN_LINE, COLOR_DATA_HOLD, COLOR_MAX_MIN_LINE };
+    // 0 -> Min, 1 -> Average, 2 -> Max, same order as in TrendEntryStruct
+    for (uint8_t tValueIndex = 0; tValueIndex < 3; ++tValueIndex) {
+        uint8_t * tDisplayBufferPtr = &DataBufferControl.DisplayBuffer[0];
+        uint16_t tIndex = tStartIndex;
+        for (uint16_t i = 0; i < tNumberOfPixels; ++i) {
+            uint16_t tValue = 0;
+            if (tValueIndex == 0) {
+                tValue = 0xFF;
+            }
+            for (uint8_t j = 0; j < tDecimation; ++j) {
+                uint8_t tEntryValue = *((uint8_t *) &TrendRecorder.Buffer[tIndex] + tValueIndex);
+                if (++tIndex >= TREND_BUFFER_SIZE) {
+                    tIndex = 0;
+                }
+                if (tValueIndex == 0) {
+                    if (tValue > tEntryValue) {
+                        tValue = tEntryValue;
+                    }
+                } else if (tValueIndex == 1) {
+                    tValue += tEntryValue;
+                } else if (tValue < tEntryValue) {
+                    tValue = tEntryValue;
+                }
+            }
+            if (tValueIndex == 1) {
+                tValue /= tDecimation;
+            }
+            memset(tDisplayBufferPtr, DISPLAY_VALUE_FOR_ZERO - tValue, tExpansion);
+            tDisplayBufferPtr += tExpansion;
+        }
+        BlueDisplay1.drawChartByteBuffer(0, 0, tColors[tValueIndex], COLOR_NO_BACKGROUND, &DataBufferControl.DisplayBuffer[0],
+                tDisplayBufferPtr - &DataBufferControl.DisplayBuffer[0]);
+    }
+
+    /*
+     * Print number of entries and frequency range
+     */
+    uint16_t tFrequencyMin = 0xFFFF;
+    uint16_t tFrequencyMax = 0;
+    // valid entries are always the first tCount entries of buffer
+    for (uint16_t i = 0; i < tCount; ++i) {
+        uint16_t tFrequency = TrendRecorder.Buffer[i].FrequencyHertz;
+        if (tFrequencyMin > tFrequency) {
+            tFrequencyMin = tFrequency;
+        }
+        if (tFrequencyMax < tFrequency) {
+            tFrequencyMax = tFrequency;
+        }
+    }
+    sprintf_P(sStringBuffer, PSTR("%u/%u * %us  %u-%uHz"), tCount, TREND_BUFFER_SIZE, TrendRecorder.IntervalSeconds,
+            tFrequencyMin, tFrequencyMax);
+    BlueDisplay1.drawText(0, TREND_INFO_Y, sStringBuffer, TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+}
+#endif
+
 void clearDataBuffer() {
+    completeReferenceStore();
     memset(DataBufferControl.DataBuffer, 0, sizeof(DataBufferControl.DataBuffer));
+    memset(DataBufferControl.SampleOverrunCountOfShot, 0, sizeof(DataBufferControl.SampleOverrunCountOfShot));
 }
 /*
  * Draws only one chart value - used for drawing while sampling
@@ -1873,11 +3008,25 @@ void printfTriggerDelay(char * aDataBufferPtr, uint16_t aTriggerDelayMillisOrMic
 }
 
 void printSingleshotMarker() {
-// draw an S to indicate running single shot trigger
-    BlueDisplay1.drawChar(SINGLESHOT_PPRINT_VALUE_X, FONT_SIZE_INFO_LONG_ASC, 'S', FONT_SIZE_INFO_LONG, COLOR_BLACK,
+// draw an S to indicate running single shot trigger or the number of the displayed shot of a sequence
+    char tMarker = 'S';
+    if (!MeasurementControl.isRunning && MeasurementControl.SequenceNumberOfShots != 0) {
+        tMarker = '1' + MeasurementControl.SequenceShotIndex;
+    }
+    BlueDisplay1.drawChar(SINGLESHOT_PPRINT_VALUE_X, FONT_SIZE_INFO_LONG_ASC, tMarker, FONT_SIZE_INFO_LONG, COLOR_BLACK,
     COLOR_INFO_BACKGROUND);
 }
 
+/*
+ * Index of shot in DataBuffer, which is acquired or displayed. 0 if no sequence.
+ */
+uint8_t getDisplayedShotIndex() {
+    if (MeasurementControl.SequenceNumberOfShots != 0) {
+        return MeasurementControl.SequenceShotIndex;
+    }
+    return 0;
+}
+
 void clearSingleshotMarker() {
     BlueDisplay1.drawChar(SINGLESHOT_PPRINT_VALUE_X, FONT_SIZE_INFO_LONG_ASC, ' ', FONT_SIZE_INFO_LONG, COLOR_BLACK,
     COLOR_BACKGROUND_DSO);
@@ -1957,15 +3106,24 @@ void printInfo(bool aRecomputeValues) {
     dtostrf(tVoltage, 5, tPrecision, tTriggerStringBuffer);
 
     uint16_t tTimebaseUnitsPerGrid;
-    if (MeasurementControl.TimebaseIndex >= TIMEBASE_INDEX_MILLIS) {
+    if (MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_MILLIS) {
         tTimebaseUnitChar = 'm';
+    } else if (MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_SECONDS) {
+        tTimebaseUnitChar = ' ';
     } else {
         tTimebaseUnitChar = '\xB5'; // micro
     }
-    tTimebaseUnitsPerGrid = pgm_read_word(&TimebaseDivPrintValues[MeasurementControl.TimebaseIndex]);
+    tTimebaseUnitsPerGrid = MeasurementControl.TimebaseDescriptor.DivPrintValue;
 
     uint32_t tHertz = MeasurementControl.FrequencyHertz;
 
+    // red info if samples of the displayed capture were lost by sample overrun
+    uint16_t tSampleOverrunCount = DataBufferControl.SampleOverrunCountOfShot[getDisplayedShotIndex()];
+    color16_t tInfoColor = COLOR_BLACK;
+    if (tSampleOverrunCount != 0) {
+        tInfoColor = COLOR_RED;
+    }
+
     if (DisplayControl.showInfoMode == INFO_MODE_LONG_INFO) {
         /*
          * Long version 1. line Timebase, Channel, (min, average, max, peak to peak) voltage, Trigger, Reference.
@@ -1996,13 +3154,24 @@ void printInfo(bool aRecomputeValues) {
         /*
          * Delay - 14 character including leading space
          */
-        if (MeasurementControl.TriggerDelayMode != TRIGGER_DELAY_NONE) {
+        if (MeasurementControl.TriggerDelayMode == TRIGGER_DELAY_MICROS) {
             strcpy_P(&sStringBuffer[35], PSTR(" del "));
             printfTriggerDelay(&sStringBuffer[40], MeasurementControl.TriggerDelayMillisOrMicros);
+        } else if (MeasurementControl.TriggerDelayMode == TRIGGER_DELAY_MILLIS) {
+            // milliseconds delay and measured delay error - 13 character including leading space
+            uint16_t tDelayErrorMicros = MeasurementControl.TriggerDelayMillisErrorMicros;
+            if (tDelayErrorMicros > 99) {
+                tDelayErrorMicros = 99;
+            }
+            sprintf_P(&sStringBuffer[35], PSTR(" %5ums+%2u\xB5s"), MeasurementControl.TriggerDelayMillisOrMicros, tDelayErrorMicros);
+        }
+        if (tSampleOverrunCount != 0) {
+            // data is not trustworthy, this is more important than the delay info
+            sprintf_P(&sStringBuffer[35], PSTR(" %4u lost"), tSampleOverrunCount);
         }
 
         BlueDisplay1.drawText(INFO_LEFT_MARGIN, FONT_SIZE_INFO_LONG_ASC + FONT_SIZE_INFO_LONG, sStringBuffer, FONT_SIZE_INFO_LONG,
-        COLOR_BLACK, COLOR_INFO_BACKGROUND);
+        tInfoColor, COLOR_INFO_BACKGROUND);
 
     } else {
         /*
@@ -2032,7 +3201,7 @@ void printInfo(bool aRecomputeValues) {
         }
 #endif
 #endif
-        BlueDisplay1.drawText(INFO_LEFT_MARGIN, FONT_SIZE_INFO_SHORT_ASC, sStringBuffer, FONT_SIZE_INFO_SHORT, COLOR_BLACK,
+        BlueDisplay1.drawText(INFO_LEFT_MARGIN, FONT_SIZE_INFO_SHORT_ASC, sStringBuffer, FONT_SIZE_INFO_SHORT, tInfoColor,
         COLOR_INFO_BACKGROUND);
     }
 }
@@ -2100,6 +3269,58 @@ void printVCCAndTemperature(void) {
     }
 }
 
+#ifdef SUPPORT_DATA_LOGGER
+/*
+ * Print one line with min/avg/max per record below the channel buttons of data logger page.
+ * Temperature is printed in degree celsius, all other channels in volt.
+ */
+#define DATA_LOGGER_VALUES_Y (2 * SETTINGS_PAGE_ROW_INCREMENT)
+void printDataLoggerValues(DataLoggerRecordStruct * aRecords, uint8_t aNumberOfRecords) {
+    uint16_t tYPos = DATA_LOGGER_VALUES_Y + TEXT_SIZE_11_ASCEND;
+    sprintf_P(sStringBuffer, PSTR("#%-5u     min     avg     max"), DataLogger.RecordNumber);
+    BlueDisplay1.drawText(0, tYPos, sStringBuffer, TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+
+    for (uint8_t i = 0; i < aNumberOfRecords; ++i) {
+        uint8_t tChannelIndex = aRecords->ChannelIndex;
+        float tValues[3] = { (float) aRecords->Min, (float) aRecords->Average, (float) aRecords->Max };
+        char tUnitChar = 'V';
+        for (uint8_t j = 0; j < 3; ++j) {
+            if (tChannelIndex == MAX_ADC_EXTERNAL_CHANNEL + 1) {
+                tUnitChar = 'C';
+                tValues[j] = (tValues[j] - 317) / 1.22; // same as getTemperature()
+            } else {
+                float tFactor = MeasurementControl.VCC / 1024.0;
+                if ((aRecords->ADMUXValue >> REFS0) == INTERNAL) {
+                    tFactor = 1.1 / 1024.0;
+                    // fixed attenuator
+                    for (uint8_t k = 0; k < tChannelIndex && k < NUMBER_OF_CHANNELS_WITH_FIXED_ATTENUATOR; ++k) {
+                        tFactor *= ATTENUATOR_FACTOR;
+                    }
+                }
+                tValues[j] *= tFactor;
+            }
+        }
+
+        strcpy_P(sStringBuffer, ADCInputMUXChannelStrings[tChannelIndex]);
+        uint8_t tLength = strlen(sStringBuffer);
+        memset(&sStringBuffer[tLength], ' ', 6 - tLength);
+        char * tBufferPtr = &sStringBuffer[6];
+        for (uint8_t j = 0; j < 3; ++j) {
+            dtostrf(tValues[j], 8, 3, tBufferPtr);
+            tBufferPtr += 8;
+        }
+        *tBufferPtr++ = tUnitChar;
+        *tBufferPtr = '\0';
+        tYPos += TEXT_SIZE_11_HEIGHT;
+        BlueDisplay1.drawText(0, tYPos, sStringBuffer, TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+        aRecords++;
+    }
+    // clear lines of deselected channels
+    BlueDisplay1.fillRectRel(0, tYPos + TEXT_SIZE_11_DECEND + 1, REMOTE_DISPLAY_WIDTH,
+            (ADC_CHANNEL_COUNT - aNumberOfRecords) * TEXT_SIZE_11_HEIGHT, COLOR_BACKGROUND_DSO);
+}
+#endif
+
 /************************************************************************
  * Utility section
  ************************************************************************/
@@ -2151,6 +3372,193 @@ uint16_t getStackFreeMinimumBytes(void) {
     return (tStackFree);
 }
 
+void resetTriggerStatistics(void) {
+    memset(&TriggerStatistics, 0, sizeof(TriggerStatistics));
+    TriggerStatistics.MillisForRate = millis();
+}
+
+/*
+ * Count trigger event and put interval to last one into histogram with logarithmic bins
+ */
+void addTriggerEvent(uint32_t aTimestamp) {
+    if (TriggerStatistics.EventCount != 0) {
+        uint32_t tInterval = aTimestamp - TriggerStatistics.LastTimestamp;
+        uint8_t tBinIndex = 0;
+        while (tInterval > 1 && tBinIndex < TRIGGER_INTERVAL_HISTOGRAM_SIZE - 1) {
+            tInterval >>= 1;
+            tBinIndex++;
+        }
+        if (TriggerStatistics.IntervalHistogram[tBinIndex] != __UINT16_MAX__) {
+            TriggerStatistics.IntervalHistogram[tBinIndex]++;
+        }
+    }
+    TriggerStatistics.LastTimestamp = aTimestamp;
+    TriggerStatistics.EventCount++;
+}
+
+/*
+ * Print event count and rate and draw interval histogram at the free 4. row position of settings page
+ */
+#define TRIGGER_STATISTICS_X BUTTON_WIDTH_3_POS_3
+#define TRIGGER_STATISTICS_Y (3 * SETTINGS_PAGE_ROW_INCREMENT)
+#define TRIGGER_STATISTICS_HISTOGRAM_HEIGHT (SETTINGS_PAGE_BUTTON_HEIGHT - TEXT_SIZE_11_HEIGHT)
+#define TRIGGER_STATISTICS_BAR_WIDTH (BUTTON_WIDTH_3 / TRIGGER_INTERVAL_HISTOGRAM_SIZE)
+void printTriggerStatistics(void) {
+    uint32_t tMillis = millis();
+    uint32_t tMillisDelta = tMillis - TriggerStatistics.MillisForRate;
+    if (tMillisDelta >= 1000) {
+        TriggerStatistics.EventsPerSecond = ((TriggerStatistics.EventCount - TriggerStatistics.EventCountForRate) * 1000)
+                / tMillisDelta;
+        TriggerStatistics.EventCountForRate = TriggerStatistics.EventCount;
+        TriggerStatistics.MillisForRate = tMillis;
+    }
+    sprintf_P(sStringBuffer, PSTR("%6lu %3u/s"), TriggerStatistics.EventCount, TriggerStatistics.EventsPerSecond);
+    BlueDisplay1.drawText(TRIGGER_STATISTICS_X, TRIGGER_STATISTICS_Y + TEXT_SIZE_11_ASCEND, sStringBuffer, TEXT_SIZE_11,
+    COLOR_BLACK, COLOR_BACKGROUND_DSO);
+
+    uint16_t tMaxCount = 1;
+    for (uint8_t i = 0; i < TRIGGER_INTERVAL_HISTOGRAM_SIZE; ++i) {
+        if (TriggerStatistics.IntervalHistogram[i] > tMaxCount) {
+            tMaxCount = TriggerStatistics.IntervalHistogram[i];
+        }
+    }
+    BlueDisplay1.fillRectRel(TRIGGER_STATISTICS_X, TRIGGER_STATISTICS_Y + TEXT_SIZE_11_HEIGHT, BUTTON_WIDTH_3,
+    TRIGGER_STATISTICS_HISTOGRAM_HEIGHT, COLOR_BACKGROUND_DSO);
+    for (uint8_t i = 0; i < TRIGGER_INTERVAL_HISTOGRAM_SIZE; ++i) {
+        uint8_t tBarHeight = ((uint32_t) TriggerStatistics.IntervalHistogram[i] * TRIGGER_STATISTICS_HISTOGRAM_HEIGHT)
+                / tMaxCount;
+        if (tBarHeight != 0) {
+            BlueDisplay1.fillRectRel(TRIGGER_STATISTICS_X + (i * TRIGGER_STATISTICS_BAR_WIDTH),
+                    TRIGGER_STATISTICS_Y + SETTINGS_PAGE_BUTTON_HEIGHT - tBarHeight, TRIGGER_STATISTICS_BAR_WIDTH - 1, tBarHeight,
+                    COLOR_GUI_TRIGGER);
+        }
+    }
+}
+
+/*
+ * Number of main loops in the last info output period. Drops if ISRs like trigger search take most of the CPU.
+ */
+void printMainLoopRate(uint16_t aLoopsPerSecond) {
+    sprintf_P(sStringBuffer, PSTR("%5u Loop/s"), aLoopsPerSecond);
+    BlueDisplay1.drawText(BUTTON_WIDTH_3_POS_3, SETTINGS_PAGE_INFO_Y, sStringBuffer,
+    TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+}
+
+#ifdef TRACE_EVENTS
+/*
+ * Appends one entry to the trace ring buffer. Called from ISR and main loop, about 25 cycles.
+ * Always inline, see addISRTiming() in ISRTiming.h.
+ */
+void traceEvent(uint8_t aEvent, uint8_t aData) {
+    uint8_t tSREG = SREG;
+    cli();
+    TraceEntryStruct * tEntry = &TraceBuffer.Entries[TraceBuffer.NextIndex];
+    TraceBuffer.NextIndex = (TraceBuffer.NextIndex + 1) & (TRACE_BUFFER_SIZE - 1);
+    if (TraceBuffer.Count < TRACE_BUFFER_SIZE) {
+        TraceBuffer.Count++;
+    }
+    tEntry->Timestamp = ((uint8_t) timer0_overflow_count << 8) | TCNT2;
+    tEntry->Event = aEvent;
+    tEntry->Data = aData;
+    SREG = tSREG;
+}
+
+/*
+ * Sends the valid entries of the trace buffer oldest first to host.
+ * After the buffer wrapped around, the entries are sent as 2 data records.
+ * Record number is the position of the first entry of the record in the sent sequence.
+ */
+void dumpTraceBuffer(void) {
+    uint8_t tSREG = SREG;
+    cli();
+    uint8_t tNextIndex = TraceBuffer.NextIndex;
+    uint8_t tCount = TraceBuffer.Count;
+    SREG = tSREG;
+
+    uint8_t tOldestIndex = 0;
+    if (tCount == TRACE_BUFFER_SIZE) {
+        tOldestIndex = tNextIndex;
+    }
+    // entries from oldest up to end of buffer or up to last written one
+    uint8_t tFirstRecordCount = tCount - tOldestIndex;
+    BlueDisplay1.writeDataRecord(DATA_RECORD_TYPE_TRACE, 0, (uint8_t*) &TraceBuffer.Entries[tOldestIndex],
+            tFirstRecordCount * sizeof(TraceEntryStruct));
+    if (tOldestIndex != 0) {
+        // wrapped part
+        BlueDisplay1.writeDataRecord(DATA_RECORD_TYPE_TRACE, tFirstRecordCount, (uint8_t*) &TraceBuffer.Entries[0],
+                tOldestIndex * sizeof(TraceEntryStruct));
+    }
+}
+#endif
+
+#ifdef MEASURE_ISR_TIMING
+/*
+ * Draw latency and duration histogram of each ISR in one row of the ISR timing page.
+ * Bars are scaled to the maximum count of each histogram.
+ */
+#define ISR_TIMING_HISTOGRAM_HEIGHT (SETTINGS_PAGE_BUTTON_HEIGHT - TEXT_SIZE_11_HEIGHT)
+#define ISR_TIMING_LATENCY_BAR_WIDTH (BUTTON_WIDTH_3 / ISR_TIMING_LATENCY_HISTOGRAM_SIZE)
+#define ISR_TIMING_DURATION_BAR_WIDTH (BUTTON_WIDTH_3 / ISR_TIMING_DURATION_HISTOGRAM_SIZE)
+void drawISRTimingHistogram(uint16_t aPositionX, uint16_t aPositionY, uint16_t * aHistogram, uint8_t aSize, uint8_t aBarWidth) {
+    uint16_t tMaxCount = 1;
+    for (uint8_t i = 0; i < aSize; ++i) {
+        if (aHistogram[i] > tMaxCount) {
+            tMaxCount = aHistogram[i];
+        }
+    }
+    BlueDisplay1.fillRectRel(aPositionX, aPositionY, BUTTON_WIDTH_3, ISR_TIMING_HISTOGRAM_HEIGHT, COLOR_BACKGROUND_DSO);
+    for (uint8_t i = 0; i < aSize; ++i) {
+        uint8_t tBarHeight = ((uint32_t) aHistogram[i] * ISR_TIMING_HISTOGRAM_HEIGHT) / tMaxCount;
+        if (tBarHeight != 0) {
+            BlueDisplay1.fillRectRel(aPositionX + (i * aBarWidth), aPositionY + ISR_TIMING_HISTOGRAM_HEIGHT - tBarHeight,
+                    aBarWidth - 1, tBarHeight, COLOR_GUI_TRIGGER);
+        }
+    }
+}
+
+void printISRTimingHistograms(void) {
+    for (uint8_t i = 0; i < ISR_TIMING_NUMBER_OF_ISRS; ++i) {
+        uint16_t tPositionY = (i + 1) * SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_HEIGHT;
+        drawISRTimingHistogram(BUTTON_WIDTH_3_POS_2, tPositionY, &ISRTiming[i].LatencyHistogram[0],
+        ISR_TIMING_LATENCY_HISTOGRAM_SIZE, ISR_TIMING_LATENCY_BAR_WIDTH);
+        drawISRTimingHistogram(BUTTON_WIDTH_3_POS_3, tPositionY, &ISRTiming[i].DurationHistogram[0],
+        ISR_TIMING_DURATION_HISTOGRAM_SIZE, ISR_TIMING_DURATION_BAR_WIDTH);
+    }
+}
+
+/*
+ * Sends the histograms of all ISRs as one data record to host.
+ * Counts may be incremented while sending, which is acceptable for statistics.
+ */
+void sendISRTiming(void) {
+    BlueDisplay1.writeDataRecord(DATA_RECORD_TYPE_ISR_TIMING, ISR_TIMING_NUMBER_OF_ISRS, (uint8_t*) &ISRTiming[0],
+            sizeof(ISRTiming));
+}
+#endif
+
+/*
+ * Maximum runtime of the loop tasks grid, reference, info and page refresh in milliseconds.
+ * A '!' after the value indicates that the task exceeded its budget at least once.
+ * Is printed at the position of VCC and temperature, which are only shown if not running.
+ */
+void printLoopTaskStatistics(void) {
+    char * tStringPointer = sStringBuffer;
+    // only the output tasks fit in the line, the store task has a fixed chunk size
+    for (uint8_t i = 0; i < LOOP_TASK_STORE_REFERENCE; ++i) {
+        uint16_t tMaxMillis = LoopTaskControl.Statistics[i].MaxMillis;
+        if (tMaxMillis > 999) {
+            tMaxMillis = 999;
+        }
+        char tExceededChar = ' ';
+        if (LoopTaskControl.Statistics[i].BudgetExceededCount != 0) {
+            tExceededChar = '!';
+        }
+        tStringPointer += sprintf_P(tStringPointer, PSTR("%3u%c"), tMaxMillis, tExceededChar);
+    }
+    BlueDisplay1.drawText(BUTTON_WIDTH_3_POS_2, SETTINGS_PAGE_INFO_Y, sStringBuffer,
+    TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+}
+
 /*
  * Show minimum free space on stack
  * Needs 260 byte of FLASH
@@ -2179,58 +3587,177 @@ uint8_t changeTimeBaseValue(int8_t aChangeIndexValue) {
         IsError = true;
     }
 
+    MeasurementControl.TimebaseIndex = tNewIndex;
+    struct TimebaseDescriptorStruct tTimebaseDescriptor;
+    memcpy_P(&tTimebaseDescriptor, &TimebaseDescriptors[tNewIndex], sizeof(tTimebaseDescriptor));
+    setTimebase(&tTimebaseDescriptor);
+    return IsError;
+}
+
+/*
+ * Sets an arbitrary sample period.
+ * Chooses the smallest timer0 prescaler which gives a CTC value <= 255 for best resolution.
+ * Sample periods above 255 * 1024 clock cycles use an additional software postscaler.
+ * The achieved sample period is stored in ExactDivMicros and used for period and frequency computation.
+ */
+void setUserSamplePeriod(uint32_t aSamplePeriodMicros) {
+    if (aSamplePeriodMicros < USER_SAMPLE_PERIOD_MICROS_MIN) {
+        aSamplePeriodMicros = USER_SAMPLE_PERIOD_MICROS_MIN;
+    } else if (aSamplePeriodMicros > USER_SAMPLE_PERIOD_MICROS_MAX) {
+        aSamplePeriodMicros = USER_SAMPLE_PERIOD_MICROS_MAX;
+    }
+    uint32_t tClockCycles = aSamplePeriodMicros * clockCyclesPerMicrosecond();
+
+    uint8_t tTimer0Prescale = TIMER0_PRESCALE8;
+    uint16_t tPostscaler = 1;
+    while (tClockCycles > (uint32_t) getTimer0PrescaleDivider(tTimer0Prescale) * 255) {
+        if (tTimer0Prescale == TIMER0_PRESCALE1024) {
+            tPostscaler = (tClockCycles + ((1024L * 255) - 1)) / (1024L * 255);
+            break;
+        }
+        tTimer0Prescale++;
+    }
+    uint32_t tDivider = (uint32_t) getTimer0PrescaleDivider(tTimer0Prescale) * tPostscaler;
+    uint16_t tCTCValue = (tClockCycles + (tDivider / 2)) / tDivider;
+    if (tCTCValue > 255) {
+        tCTCValue = 255;
+    }
+
+    struct TimebaseDescriptorStruct tTimebaseDescriptor;
+    tTimebaseDescriptor.Timer0Prescale = tTimer0Prescale;
+    tTimebaseDescriptor.CTCValue = tCTCValue;
+    tTimebaseDescriptor.SamplePostscaler = tPostscaler;
+    tTimebaseDescriptor.XScale = 1;
+
+    /*
+     * Use the slowest ADC prescaler which finishes conversion before next timer0 trigger
+     */
+    uint32_t tTimer0PeriodClockCycles = (uint32_t) tCTCValue * getTimer0PrescaleDivider(tTimer0Prescale);
+    uint8_t tADCPrescale = ADC_PRESCALE128;
+    while (((uint32_t) ADC_CYCLES_PER_CONVERSION << tADCPrescale) > tTimer0PeriodClockCycles) {
+        tADCPrescale--;
+    }
+    tTimebaseDescriptor.ADCPrescale = tADCPrescale;
+    tTimebaseDescriptor.FirstSampleDelay4Micros = TIMEBASE_FIRST_SAMPLE_SKIP;
+    if (tADCPrescale <= ADC_PRESCALE16) {
+        // like the 496 us range, the short conversion allows to take the trigger value as first sample
+        tTimebaseDescriptor.FirstSampleDelay4Micros = 0;
+    }
+
+    float tExactDivMicros = ((float) (tTimer0PeriodClockCycles * tPostscaler * TIMING_GRID_WIDTH)) / clockCyclesPerMicrosecond();
+    tTimebaseDescriptor.ExactDivMicros = tExactDivMicros;
+
+    uint8_t tFlags = TIMEBASE_FLAG_USER_SAMPLE_PERIOD;
+    uint32_t tDivMicros = tExactDivMicros + 0.5;
+    if (tDivMicros >= 1000000L) {
+        tFlags |= TIMEBASE_FLAG_SECONDS;
+        tTimebaseDescriptor.DivPrintValue = (tDivMicros + 500000L) / 1000000L;
+    } else if (tDivMicros >= 1000) {
+        tFlags |= TIMEBASE_FLAG_MILLIS;
+        tTimebaseDescriptor.DivPrintValue = (tDivMicros + 500) / 1000;
+    } else {
+        tTimebaseDescriptor.DivPrintValue = tDivMicros;
+    }
+    if (tDivMicros >= USER_SAMPLE_PERIOD_DRAW_WHILE_ACQUIRE_MIN_DIV_MICROS) {
+        tFlags |= TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE;
+    }
+    tTimebaseDescriptor.Flags = tFlags;
+
+    /*
+     * Trigger timeout like for fixed timebases, see TimebaseDescriptors[]
+     */
+    uint32_t tTriggerTimeoutSampleCount = (tDivMicros * 3) / 1000;
+    if (tTriggerTimeoutSampleCount < 30) {
+        tTriggerTimeoutSampleCount = 30;
+    } else if (tTriggerTimeoutSampleCount > 900) {
+        tTriggerTimeoutSampleCount = 900;
+    }
+    tTimebaseDescriptor.TriggerTimeoutSampleCount = tTriggerTimeoutSampleCount;
+
+    /*
+     * Set index to the next faster fixed timebase, to have a reasonable start for timebase swipes
+     */
+    uint8_t tNewIndex = TIMEBASE_NUMBER_OF_ENTRIES - 1;
+    while (tNewIndex > 0 && pgm_read_float(&TimebaseDescriptors[tNewIndex].ExactDivMicros) > tExactDivMicros) {
+        tNewIndex--;
+    }
+    MeasurementControl.TimebaseIndex = tNewIndex;
+
+    setTimebase(&tTimebaseDescriptor);
+}
+
+/*
+ * Copies descriptor to MeasurementControl and sets the timer 0
+ * setTimebase() needs:
+ * TriggerMode
+ * AttenuatorValue
+ *
+ * setTimebase() sets:
+ * DrawWhileAcquire
+ * TriggerTimeoutSampleCount
+ * XScale
+ * Timer0
+ */
+void setTimebase(struct TimebaseDescriptorStruct * aTimebaseDescriptor) {
     bool tStartNewAcquisition = false;
-    DisplayControl.DrawWhileAcquire = (tNewIndex >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE);
+    bool tOldDrawWhileAcquire = DisplayControl.DrawWhileAcquire;
+    DisplayControl.DrawWhileAcquire = aTimebaseDescriptor->Flags & TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE;
 
-    if (tOldIndex >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE && tNewIndex < TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE) {
+    if (tOldDrawWhileAcquire && !DisplayControl.DrawWhileAcquire) {
         // from draw while acquire to normal mode -> stop acquisition, clear old chart, and start a new one
         ADCSRA &= ~_BV(ADIE); // stop acquisition - disable ADC interrupt
         clearDisplayedChart(&DataBufferControl.DisplayBuffer[0]);
         tStartNewAcquisition = true;
     }
 
-    if (tOldIndex < TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE && tNewIndex >= TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE) {
+    if (!tOldDrawWhileAcquire && DisplayControl.DrawWhileAcquire) {
         // from normal to draw while acquire mode
         ADCSRA &= ~_BV(ADIE); // stop acquisition - disable ADC interrupt
         clearDisplayedChart(&DataBufferControl.DataBuffer[0]);
         tStartNewAcquisition = true;
     }
 
-    MeasurementControl.TimebaseIndex = tNewIndex;
+    MeasurementControl.TimebaseDescriptor = *aTimebaseDescriptor;
 
     /*
-     * Set trigger timeout. Used only for trigger modes with timeout.
+     * Trigger search rate of 4 to 8 times the sample rate keeps the trigger error below one sample
+     * and reduces the ADC ISR load while waiting for trigger from 150000 down to 9600 interrupts per second.
+     * With app. 6 microseconds per trigger search ISR (see ISR(ADC_vect)) this is 92 % versus 6 % of the CPU time,
+     * estimated from the cycle counts, not measured. Loop/s on the settings page shows the actual remaining CPU time.
+     * Timebases with a FirstSampleDelay4Micros are tuned for the latency of the fastest search and keep it.
      */
-    uint16_t tTriggerTimeoutSampleCount;
+    uint8_t tSearchPrescale = ADC_PRESCALE_FOR_TRIGGER_SEARCH;
+    if (!(aTimebaseDescriptor->Flags & TIMEBASE_FLAG_FAST_MODE)
+            && aTimebaseDescriptor->FirstSampleDelay4Micros == TIMEBASE_FIRST_SAMPLE_SKIP) {
+        uint32_t tSamplePeriodClockCycles = (uint32_t) aTimebaseDescriptor->CTCValue
+                * getTimer0PrescaleDivider(aTimebaseDescriptor->Timer0Prescale) * aTimebaseDescriptor->SamplePostscaler;
+        while (tSearchPrescale < ADC_PRESCALE_MAX_VALUE
+                && (((uint32_t) ADC_CYCLES_PER_CONVERSION * TRIGGER_SEARCH_CONVERSIONS_PER_SAMPLE) << (tSearchPrescale + 1))
+                        <= tSamplePeriodClockCycles) {
+            tSearchPrescale++;
+        }
+    }
+    MeasurementControl.TriggerSearchADCPrescale = tSearchPrescale;
+
     /*
-     * Try to have the time for showing one display as trigger timeout
-     * Don't go below 1/10 of a second (30 * 256 samples) and above 3 seconds (900)
-     * 10 ms Range => timeout = 100 millisecond
-     * 20 ms => 200 ms, 50 ms => 500 ms, 100 ms => 1s, 200 ms => 2s, 500 ms => 3s
-     * Trigger is always running with ADC at free running mode at 1 us clock => 13 us per conversion
-     * which gives 77k samples for 1 second
+     * Set trigger timeout. Used only for trigger modes with timeout.
+     * Values of descriptor are for ADC_PRESCALE_FOR_TRIGGER_SEARCH, so adjust them to the actual search rate.
      */
-    if (tNewIndex <= 9) {
-        tTriggerTimeoutSampleCount = 30;
-    } else if (tNewIndex >= 14) {
-        tTriggerTimeoutSampleCount = 900;
-    } else {
-        tTriggerTimeoutSampleCount = pgm_read_word(&TimebaseDivPrintValues[tNewIndex]) * 3;
+    uint16_t tTriggerTimeoutSampleCount = aTimebaseDescriptor->TriggerTimeoutSampleCount
+            >> (tSearchPrescale - ADC_PRESCALE_FOR_TRIGGER_SEARCH);
+    if (tTriggerTimeoutSampleCount == 0) {
+        tTriggerTimeoutSampleCount = 1;
     }
-
     MeasurementControl.TriggerTimeoutSampleCount = tTriggerTimeoutSampleCount;
 
 // reset xScale to regular value
-    if (MeasurementControl.TimebaseIndex < TIMEBASE_NUMBER_OF_XSCALE_CORRECTION) {
-        DisplayControl.XScale = xScaleForTimebase[tNewIndex];
-    } else {
-        DisplayControl.XScale = 1;
-    }
+    DisplayControl.XScale = aTimebaseDescriptor->XScale;
     if (tStartNewAcquisition) {
         startAcquisition();
     }
 
-    if (tNewIndex >= TIMEBASE_NUMBER_OF_FAST_MODES) {
+    // a running microseconds trigger delay restores timer0 from the new descriptor at its end
+    if (!(aTimebaseDescriptor->Flags & TIMEBASE_FLAG_FAST_MODE) && !MeasurementControl.TriggerDelayTimerIsRunning) {
         /*
          * set timer 0
          */
@@ -2240,20 +3767,9 @@ uint8_t changeTimeBaseValue(int8_t aChangeIndexValue) {
         } else {
             TCCR0A = _BV(WGM01); // CTC mode
         }
-        uint8_t tTimer0HWPrescaler;
-        if (tNewIndex < 8) {
-            tTimer0HWPrescaler = TIMER0_PRESCALE8;
-        } else if (tNewIndex < 11) {
-            tTimer0HWPrescaler = TIMER0_PRESCALE64;
-        } else if (tNewIndex < 13) {
-            tTimer0HWPrescaler = TIMER0_PRESCALE256;
-        } else {
-            tTimer0HWPrescaler = TIMER0_PRESCALE1024;
-        }
-        TCCR0B = tTimer0HWPrescaler;
-        OCR0A = CTCValueforTimebase[tNewIndex - TIMEBASE_NUMBER_OF_FAST_MODES] - 1;
+        TCCR0B = aTimebaseDescriptor->Timer0Prescale;
+        OCR0A = aTimebaseDescriptor->CTCValue - 1;
     }
-    return IsError;
 }
 
 uint8_t getDisplayFromRawInputValue(uint16_t aRawValue) {
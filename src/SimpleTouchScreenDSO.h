@@ -10,6 +10,7 @@
 #define SIMPLETOUCHSCREENDSO_H_
 
 #include "TouchDSOCommon.h"
+#include "ISRTiming.h"
 
 // Internal version
 #define VERSION_DSO "3.2"
@@ -33,6 +34,47 @@
 #define BLUETOOTH_BAUD_RATE BAUD_9600
 #endif
 
+/*
+ * Activate this, if your BlueDisplay app supports FUNCTION_DRAW_CHART_WITH_X_STEP.
+ * Then for XScale > 1 only the real samples are sent and the app expands them, which reduces the bytes sent by XScale.
+ */
+//#define USE_REMOTE_CHART_X_STEP
+
+/*
+ * Activate this, if your BlueDisplay app supports FUNCTION_LAYER_SETTINGS.
+ * Then grid, trigger line and voltage picker line are drawn on their own layers below the chart.
+ * The grid is only drawn if it changes and lines are removed by clearing their layer instead of restoring the grid.
+ * Layers cannot be shown or hidden, so e.g. reference waveforms are not put on a layer and are redrawn instead.
+ */
+//#define USE_REMOTE_LAYERS
+
+/*
+ * Activate this, if your BlueDisplay app supports FUNCTION_WRITE_DATA_RECORD.
+ * Then the data logger sends min, average and max of each interval as binary record to the host.
+ * Otherwise they are only shown as text on the data logger page.
+ * The dumps of TRACE_EVENTS and MEASURE_ISR_TIMING always use data records, since they are debug options anyway.
+ */
+//#define USE_REMOTE_DATA_RECORDS
+#ifdef USE_REMOTE_LAYERS
+#define DSO_LAYER_DEFAULT 0 // chart, text, buttons and sliders
+#define DSO_LAYER_TRIGGER_LINE 1
+#define DSO_LAYER_VOLTAGE_PICKER 2
+#define DSO_LAYER_GRID 3 // lowest layer
+#endif
+
+/*
+ * Keep the ISR parameters ShiftValue and OffsetValue in the general purpose I/O registers GPIOR0 to GPIOR2.
+ * The ISR reads them with single cycle "in" instructions instead of "lds" from SRAM.
+ * They are reloaded by loadISRStateRegisters() with each change of range or offset.
+ * This saves 2 cycles for the 3 loads and about 6 cycles for the shift, which is done by fixed shifts.
+ * DataBufferNextInPointer, ValueMinForISR, ValueMaxForISR and IntegrateValueForAverage stay in SRAM,
+ * since the 3 GPIOR bytes are used up and they are written back on every sample anyway.
+ */
+//#define ISR_STATE_IN_GPIOR
+#ifdef ISR_STATE_IN_GPIOR
+void loadISRStateRegisters(void);
+#endif
+
 #define MILLIS_BETWEEN_INFO_OUTPUT 1000
 
 /*
@@ -79,6 +121,9 @@ const unsigned int REMOTE_DISPLAY_WIDTH = DISPLAY_HALF_VGA_WIDTH; // 320
 // GUI element colors
 
 #define COLOR_SLIDER RGB(0xD0,0xD0,0xD0)
+#define COLOR_REFERENCE_0 RGB(0xFF,0x80,0x00) // orange
+#define COLOR_REFERENCE_1 RGB(0x00,0xC0,0xC0) // cyan
+#define COLOR_REFERENCE_2 RGB(0xA0,0x60,0x20) // brown
 
 // No trigger wait timeout for modes != TRIGGER_DELAY_NONE
 #define TRIGGER_DELAY_NONE 0
@@ -87,12 +132,109 @@ const unsigned int REMOTE_DISPLAY_WIDTH = DISPLAY_HALF_VGA_WIDTH; // 320
 
 #define TRIGGER_DELAY_MICROS_POLLING_ADJUST_COUNT 1 // estimated value to be subtracted from value because of fast mode initial delay
 #define TRIGGER_DELAY_MICROS_ISR_ADJUST_COUNT 4 // estimated value to be subtracted from value because of ISR initial delay
+#define TRIGGER_DELAY_MICROS_TIMER0_MIN 2 // 32 cycles. The last trigger search conversion must be finished before the first compare match
+#define TRIGGER_DELAY_TIMER2_TICKS_PER_MILLI 250 // timer2 runs with 4 us ticks and period of 256 ticks
+
+/*
+ * Timeout for external trigger in fast modes in timer2 periods of 1.024 ms. Was 65536 polling loops before.
+ * Can be set at compile time, e.g. with -DTRIGGER_EXTERN_WAIT_TIMER2_OVERFLOWS=100. Max. 255 (261 ms).
+ * Single shot mode returns to the main loop after each timeout, so longer values delay the GUI response.
+ */
+#ifndef TRIGGER_EXTERN_WAIT_TIMER2_OVERFLOWS
+#define TRIGGER_EXTERN_WAIT_TIMER2_OVERFLOWS 25 // 25.6 ms
+#endif
 
 // States of tTriggerStatus
 #define TRIGGER_STATUS_START 0 // No trigger condition met
 #define TRIGGER_STATUS_AFTER_HYSTERESIS 1 // slope and hysteresis condition met, wait to go beyond trigger level without hysteresis.
 #define TRIGGER_STATUS_FOUND 2 // Trigger condition met - Used for shorten ISR handling
-#define TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY 3 // Trigger condition met and waiting for ms delay
+#define TRIGGER_STATUS_FOUND_AND_WAIT_FOR_DELAY 3 // Trigger condition met and waiting for ms or us delay
+
+#define SEQUENCE_NUMBER_OF_SHOTS_MAX (DATABUFFER_SIZE / REMOTE_DISPLAY_WIDTH) // 3 shots of one screen each
+
+#define TRIGGER_INTERVAL_HISTOGRAM_SIZE 20 // bin n holds intervals from 2^n to 2^(n+1)-1 timer2 ticks of 4 us, last bin holds all >= 2 s
+
+/*
+ * Including their button handles, the data logger needs 100 bytes and the trend recorder 345 bytes of static RAM.
+ * Comment out a feature, if the stack needs this RAM, e.g. for TRACE_EVENTS or MEASURE_ISR_TIMING.
+ */
+#define SUPPORT_DATA_LOGGER
+#define SUPPORT_TREND_RECORDER
+
+/*
+ * Data logger
+ */
+#define DATA_LOGGER_TIMER0_PRESCALE TIMER0_PRESCALE1024
+#define DATA_LOGGER_CTC_VALUE 78 // 78 * 64 us = 4.992 ms between two conversions
+#define DATA_LOGGER_READ_COMPARE_VALUE (DATA_LOGGER_CTC_VALUE / 2) // timer0 compare B reads result 2.5 ms after start of conversion
+/*
+ * ADMUX is switched at compare B, so the first conversion with the new reference starts 2.5 ms later.
+ * Discarding 2 conversions starts the first valid one 12.5 ms after the switch, which covers the 10 ms settling of the reference.
+ */
+#define DATA_LOGGER_REFERENCE_SETTLING_CONVERSIONS 2
+#define DATA_LOGGER_INTERVAL_SECONDS_DEFAULT 1
+#define DATA_LOGGER_INTERVAL_SECONDS_MAX 300 // 16 bit conversion count per channel and interval
+#define DATA_LOGGER_RECORD_TYPE_MIN_AVERAGE_MAX 0
+#define DATA_RECORD_TYPE_TRACE 1 // content of trace buffer, see TRACE_EVENTS
+#define DATA_RECORD_TYPE_ISR_TIMING 2 // ISR latency and duration histograms, see MEASURE_ISR_TIMING
+
+/*
+ * Event trace for tuning the acquisition and transmit pipeline.
+ * Activate it to record the last TRACE_BUFFER_SIZE events in a ring buffer. Long touch at the settings page sends it to host.
+ */
+//#define TRACE_EVENTS
+#define TRACE_BUFFER_SIZE 64 // must be a power of 2, 4 bytes per entry
+
+/*
+ * Trend recorder
+ */
+#define TREND_BUFFER_SIZE 64 // 320 bytes of RAM. Each entry is shown with 5 pixel at the display width of 320
+#define TREND_INTERVAL_SECONDS_DEFAULT 1
+#define TREND_INTERVAL_SECONDS_MAX 3600
+
+/*
+ * Reference waveforms
+ */
+#define REFERENCE_SLOT_COUNT 3 // 3 * 320 byte fits in 1 kByte EEPROM of ATmega328
+/*
+ * Each drawn chunk has its own chart index, which has 4 bits. Chunks overlap by one value in order to connect them.
+ */
+#define REFERENCE_DRAW_CHUNKS_PER_SLOT 5
+#define REFERENCE_DRAW_CHUNK_SIZE ((REMOTE_DISPLAY_WIDTH / REFERENCE_DRAW_CHUNKS_PER_SLOT) + 1) // 65 byte stack buffer for drawing
+#define REFERENCE_REFRESH_INFO_OUTPUT_COUNT 5 // In running mode refresh references only every 5. info output to save bandwidth
+#define REFERENCE_CHART_INDEX_FIRST 1 // chart index of first chunk of slot 0 for the remote side, index 0 is the DSO chart
+#define REFERENCE_STORE_CHUNK_SIZE 32 // bytes written to EEPROM per loop task, takes up to 110 ms
+
+/*
+ * Timebase descriptor. One entry for each timebase index, see TimebaseDescriptors[] in SimpleTouchScreenDSO.cpp
+ */
+#define TIMEBASE_FLAG_FAST_MODE             0x01 // free running ADC with polling instead of ISR
+#define TIMEBASE_FLAG_ULTRAFAST_MODE        0x02 // polling without preprocessing, stores 16 bit raw values and therefore needs double buffer size
+#define TIMEBASE_FLAG_MILLIS                0x04 // DivPrintValue is milliseconds instead of microseconds
+#define TIMEBASE_FLAG_DRAW_WHILE_ACQUIRE    0x08 // chart is drawn while buffer is filled
+#define TIMEBASE_FLAG_SECONDS               0x10 // DivPrintValue is seconds instead of microseconds
+#define TIMEBASE_FLAG_USER_SAMPLE_PERIOD    0x20 // values are computed by setUserSamplePeriod() and not taken from TimebaseDescriptors[]
+
+#define USER_SAMPLE_PERIOD_MICROS_MIN 16 // the sample period of the 496 us range
+#define USER_SAMPLE_PERIOD_MICROS_MAX ((255L * 255L * 1024L) / 16) // max CTC value * max postscaler * max timer0 prescaler
+#define USER_SAMPLE_PERIOD_DRAW_WHILE_ACQUIRE_MIN_DIV_MICROS 50000L
+
+#define TIMEBASE_FIRST_SAMPLE_SKIP 0xFF // value for FirstSampleDelay4Micros. Ignore the trigger value and take next value as first one
+
+struct TimebaseDescriptorStruct {
+    float ExactDivMicros; // exact value for 31 pixel grid - for period and frequency
+    uint16_t DivPrintValue; // value for info line, unit is given by TIMEBASE_FLAG_MILLIS
+    uint16_t TriggerTimeoutSampleCount; // trigger timeout in units of 256 samples
+    uint8_t ADCPrescale; // ADC_PRESCALE*
+    uint8_t Timer0Prescale; // TIMER0_PRESCALE* - not used for fast modes
+    uint8_t CTCValue; // OCR0A + 1 - not used for fast modes
+    uint8_t SamplePostscaler; // number of timer0 periods per stored sample, for timebases slower than timer0 can generate
+    uint8_t XScale; // multiply displayed values to simulate a faster timebase
+    uint8_t FirstSampleDelay4Micros; // delay from trigger to first sample in 1/4 microseconds or TIMEBASE_FIRST_SAMPLE_SKIP
+    uint8_t Flags; // TIMEBASE_FLAG_*
+};
+extern const struct TimebaseDescriptorStruct TimebaseDescriptors[] PROGMEM;
+void setTimebase(struct TimebaseDescriptorStruct * aTimebaseDescriptor);
 
 /*
  * External attenuator values
@@ -108,6 +250,9 @@ struct MeasurementControlStruct {
     bool StopRequested;
     // Used to disable trigger timeout and to specify full buffer read with stop after first read.
     bool isSingleShotMode;
+    // Sequence of single shots, stored back to back in DataBuffer. Rearmed without drawing.
+    uint8_t SequenceNumberOfShots; // 0 -> no sequence in DataBuffer
+    uint8_t SequenceShotIndex; // shot actually acquired or displayed
 
     float VCC; // Volt of VCC
     uint8_t ADCReference; // DEFAULT = 1 =VCC   INTERNAL = 3 = 1.1 volt
@@ -130,17 +275,31 @@ struct MeasurementControlStruct {
     uint16_t RawHysteresis;             // quarter of peak to peak value
     uint16_t ValueBeforeTrigger;
 
-    uint32_t TriggerDelayMillisEnd; // value of millis() at end of milliseconds trigger delay
+    uint16_t Timer2MillisRemaining; // number of timer2 compare B matches (milliseconds) until end of milliseconds trigger delay
+    uint16_t TriggerDelayMillisErrorMicros; // measured latency of the end of the last milliseconds trigger delay
     uint16_t TriggerDelayMillisOrMicros;
     uint8_t TriggerDelayMode; //  TRIGGER_DELAY_NONE 0, TRIGGER_DELAY_MICROS 1, TRIGGER_DELAY_MILLIS 2. Threshold is  __UINT16_MAX__
+    bool TriggerDelayTimerIsRunning; // timer0 is used as one shot timer for microseconds trigger delay
+    uint16_t TriggerDelayTimer0PeriodsRemaining; // number of 256 cycle timer0 periods until end of microseconds trigger delay
 
     // Using type TriggerMode instead of uint8_t increases program size by 76 bytes
     uint8_t TriggerMode; // adjust values automatically
     uint8_t OffsetMode; //OFFSET_MODE_0_VOLT, OFFSET_MODE_AUTOMATIC, OFFSET_MODE_MANUAL
     uint8_t TriggerStatus; //TRIGGER_STATUS_START 0, TRIGGER_STATUS_BEFORE_THRESHOLD 1, TRIGGER_STATUS_OK 2
+    bool TriggerTimestampIsValid; // set by ISR if trigger condition (not timeout) was met, reset by main loop
+    uint32_t TriggerTimestamp; // timer2 ticks (4 us) extended by timer2 overflow count
     uint8_t TriggerSampleCountPrecaler; // for dividing sample count by 256 - to avoid 32bit variables in ISR
     uint16_t TriggerSampleCountDividedBy256; // for trigger timeout
     uint16_t TriggerTimeoutSampleCount; // ISR max samples before trigger timeout. Used only for trigger modes with timeout.
+    uint8_t TriggerSearchADCPrescale; // ADC_PRESCALE* for free running trigger search, depends on timebase
+
+    // Sample overrun detection with timer2 as independent time base, see ISR(ADC_vect)
+    uint16_t OverrunCheckSamplePeriodCycles; // CPU cycles between 2 timer0 compare matches, 0 if check is not required for timebase
+    uint8_t OverrunCheckTimer0Divider; // 8 or 64, converts TCNT0 to CPU cycles
+    uint8_t OverrunCheckTimer0Count; // TCNT0 at last ADC ISR call
+    uint8_t OverrunCheckTimer2Count; // TCNT2 at last ADC ISR call
+    bool OverrunCheckConversionWasRunning; // ADSC at last ADC ISR call
+    uint16_t SampleOverrunCount; // samples of actual acquisition lost, because ADC ISR was delayed by other ISRs
 
     // Statistics (for info and auto trigger)
     uint16_t RawValueMin;
@@ -158,6 +317,8 @@ struct MeasurementControlStruct {
     bool AcquisitionFastMode;
     uint8_t TimebaseIndex;
     uint8_t TimebaseHWValue;
+    struct TimebaseDescriptorStruct TimebaseDescriptor; // copy of TimebaseDescriptors[TimebaseIndex] or user sample period values
+    uint8_t SamplePostscalerCount; // number of samples to skip until next sample is stored
 
     bool RangeAutomatic; // RANGE_MODE_AUTOMATIC, MANUAL
 
@@ -182,6 +343,11 @@ extern struct MeasurementControlStruct MeasurementControl;
 #ifndef AVR
 #define DISPLAY_PAGE_MORE_SETTINGS 4
 #define DISPLAY_PAGE_SYST_INFO 5
+#else
+#define DISPLAY_PAGE_DATA_LOGGER 4
+#define DISPLAY_PAGE_TREND 5
+#define DISPLAY_PAGE_REFERENCE 6
+#define DISPLAY_PAGE_ISR_TIMING 7 // only with MEASURE_ISR_TIMING
 #endif
 
 // modes for showInfoMode
@@ -198,6 +364,12 @@ struct DisplayControlStruct {
 
     bool showHistory;
     uint16_t EraseColor;
+
+    uint8_t ReferenceShowMask; // bit n set -> reference slot n is drawn as overlay
+    uint8_t ReferenceStoreSlot; // slot written by LOOP_TASK_STORE_REFERENCE
+    uint16_t ReferenceStoreIndex; // next display value to be written to slot
+    uint8_t * ReferenceStoreSource; // DataBufferDisplayStart at time of store
+    uint8_t ReferenceStoreXScale; // XScale at time of store
 };
 extern DisplayControlStruct DisplayControl;
 
@@ -217,15 +389,175 @@ struct DataBufferStruct {
     uint16_t AcquisitionSize;
     // Pointer for horizontal scrolling
     uint8_t * DataBufferDisplayStart;
+    // Lost samples of each capture in DataBuffer, copied from MeasurementControl.SampleOverrunCount at buffer full. Index is shot of sequence.
+    uint16_t SampleOverrunCountOfShot[SEQUENCE_NUMBER_OF_SHOTS_MAX];
     uint8_t DataBuffer[DATABUFFER_SIZE]; // contains also display values i.e. (DISPLAY_VALUE_FOR_ZERO - 8BitValue)
 };
 extern DataBufferStruct DataBufferControl;
 
+/*
+ * Trigger event statistics. Updated by main loop for every acquisition with a real trigger event.
+ * Trigger events during drawing and re-arming are not seen, so intervals are never shorter than one acquisition cycle.
+ */
+struct TriggerStatisticsStruct {
+    uint32_t EventCount;
+    uint32_t LastTimestamp;
+    uint16_t IntervalHistogram[TRIGGER_INTERVAL_HISTOGRAM_SIZE];
+    // for event rate
+    uint32_t EventCountForRate;
+    uint32_t MillisForRate;
+    uint16_t EventsPerSecond;
+};
+extern TriggerStatisticsStruct TriggerStatistics;
+
+/*
+ * Data logger scanning the selected ADC channels round robin at each timer0 compare match
+ */
+struct DataLoggerChannelStruct {
+    uint16_t Min;
+    uint16_t Max;
+    uint32_t Sum;
+    uint16_t Count;
+};
+
+// binary record of one channel for one interval, sent to host. Raw 10 bit ADC values.
+struct DataLoggerRecordStruct {
+    uint8_t ChannelIndex;
+    uint8_t ADMUXValue; // contains reference and MUX channel
+    uint16_t Min;
+    uint16_t Average;
+    uint16_t Max;
+}__attribute__((packed));
+
+struct DataLoggerStruct {
+    bool isRunning;
+    uint8_t ChannelMask; // bit n set -> channel index n (as used by setChannel()) is scanned. Never 0.
+    uint8_t ChannelIndex; // channel of current conversion
+    uint8_t DiscardSampleCount; // set by ISR if reference was switched
+    uint8_t ADMUXValues[ADC_CHANNEL_COUNT];
+    uint16_t IntervalSeconds;
+    uint32_t MillisOfLastRecord;
+    uint16_t RecordNumber;
+    DataLoggerChannelStruct Channels[ADC_CHANNEL_COUNT]; // written by ISR
+};
+#ifdef SUPPORT_DATA_LOGGER
+extern DataLoggerStruct DataLogger;
+#endif
+
+/*
+ * Trend recorder. Reduces all acquisitions of one interval to one entry of a circular buffer.
+ * Values are 8 bit raw values i.e. (10 bit ADC value >> 2).
+ */
+struct TrendEntryStruct {
+    uint8_t Min;
+    uint8_t Average;
+    uint8_t Max;
+    uint16_t FrequencyHertz; // 0 if no period found, saturated at 0xFFFF
+}__attribute__((packed));
+
+struct TrendRecorderStruct {
+    TrendEntryStruct Buffer[TREND_BUFFER_SIZE];
+    uint16_t NextIndex; // index of entry to be written next
+    uint16_t Count; // number of valid entries <= TREND_BUFFER_SIZE
+    uint16_t IntervalSeconds;
+    uint32_t MillisOfIntervalStart;
+    // accumulated raw values of current interval
+    uint16_t RawMin;
+    uint16_t RawMax;
+    uint32_t AverageSum;
+    uint32_t AcquisitionCount;
+};
+#ifdef SUPPORT_TREND_RECORDER
+extern TrendRecorderStruct TrendRecorder;
+#endif
+
+/*
+ * Deferred task queue of the running main loop. Tasks are deferred until the next acquisition is started
+ * and run one per main loop, if no acquired data is waiting. Lower number is higher priority.
+ * There is no latency bound, a task waits as long as tasks with higher priority are pending.
+ */
+#define LOOP_TASK_GRID              0 // restore grid, which is partially cleared by clearing the old chart. Done before drawing the new chart.
+#define LOOP_TASK_REFERENCE         1 // refresh reference waveforms
+#define LOOP_TASK_INFO              2 // print info line
+#define LOOP_TASK_PAGE_REFRESH      3 // refresh buttons of settings or frequency page
+#define LOOP_TASK_STORE_REFERENCE   4 // write next chunk of a reference waveform to EEPROM
+#define LOOP_TASK_NUMBER_OF_TASKS   5
+
+struct LoopTaskStatisticsStruct {
+    uint16_t MaxMillis;
+    uint8_t BudgetExceededCount; // saturated at 0xFF
+};
+
+struct LoopTaskControlStruct {
+    uint8_t PendingMask; // bit n set -> task n is pending
+    LoopTaskStatisticsStruct Statistics[LOOP_TASK_NUMBER_OF_TASKS];
+};
+extern LoopTaskControlStruct LoopTaskControl;
+
+extern const uint16_t ReferenceColors[REFERENCE_SLOT_COUNT] PROGMEM;
+
+#ifdef TRACE_EVENTS
+#define TRACE_EVENT_START_ACQUISITION   0 // Data is timebase index
+#define TRACE_EVENT_TRIGGER_FOUND       1 // Data is trigger mode, not recorded for trigger timeout
+#define TRACE_EVENT_BUFFER_FULL         2
+#define TRACE_EVENT_DRAW_START          3
+#define TRACE_EVENT_DRAW_END            4
+#define TRACE_EVENT_RECEIVED            5 // Data is BlueDisplay event type
+#define TRACE_EVENT_RANGE_CHANGE        6 // Data is new shift value
+#define TRACE_EVENT_SAMPLE_OVERRUN      7 // Data is number of lost samples
+
+struct TraceEntryStruct {
+    // Low 16 bit of timer2 timestamp with 4 us resolution. High byte stops during acquisition, since millis() interrupt is disabled.
+    uint16_t Timestamp;
+    uint8_t Event; // TRACE_EVENT_*
+    uint8_t Data;
+};
+
+struct TraceBufferStruct {
+    uint8_t NextIndex; // index of entry to be written next, which is the oldest one if Count == TRACE_BUFFER_SIZE
+    uint8_t Count; // number of valid entries, saturated at TRACE_BUFFER_SIZE
+    TraceEntryStruct Entries[TRACE_BUFFER_SIZE];
+};
+extern TraceBufferStruct TraceBuffer;
+void dumpTraceBuffer(void);
+#define TRACE_EVENT(aEvent, aData) traceEvent(aEvent, aData)
+#else
+#define TRACE_EVENT(aEvent, aData)
+#endif
+
+#ifdef MEASURE_ISR_TIMING
+void drawISRTimingPage(void);
+void printISRTimingHistograms(void);
+void sendISRTiming(void);
+#endif
+
 // Utility section
 uint16_t getInputRawFromDisplayValue(uint8_t aDisplayValue);
 float getFloatFromDisplayValue(uint8_t aDisplayValue);
 void printSingleshotMarker();
 void clearSingleshotMarker();
+uint8_t getDisplayedShotIndex();
+void resetTriggerStatistics(void);
+void printTriggerStatistics(void);
+void printMainLoopRate(uint16_t aLoopsPerSecond);
+void runPendingLoopTask(void);
+void printLoopTaskStatistics(void);
+#ifdef SUPPORT_DATA_LOGGER
+void startDataLogger(void);
+void stopDataLogger(void);
+void loopDataLogger(void);
+void resetDataLoggerChannel(uint8_t aChannelIndex);
+void printDataLoggerValues(DataLoggerRecordStruct * aRecords, uint8_t aNumberOfRecords);
+#endif
+#ifdef SUPPORT_TREND_RECORDER
+void clearTrendRecorder(void);
+void addTrendValues(void);
+void drawTrendChart(void);
+#endif
+bool storeReference(uint8_t aSlot);
+bool storeReferenceChunk(void);
+void completeReferenceStore(void);
+void drawReferenceCharts(void);
 extern "C" void INT0_vect();
 
 // for printf etc.
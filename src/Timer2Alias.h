@@ -0,0 +1,35 @@
+/*
+ * Timer2Alias.h
+ *
+ * Maps the timer2 registers used for millis(), the milliseconds trigger delay and the ISR timing to timer3,
+ * if the CPU has no timer2. Must be included by each file which accesses timer2.
+ *
+ *  Copyright (C) 2026  agent
+ *  Email: agent@local
+ *  License: GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ */
+
+#ifndef TIMER2ALIAS_H_
+#define TIMER2ALIAS_H_
+
+#include <avr/io.h>
+
+#if !defined(TIMSK2)
+/*
+ * On ATmega32U4 we have no timer2 but one timer3, which runs in 8 bit fast PWM mode with 4 us clock, see initTimer2().
+ * TCNT3 counts only from 0 to 0xFF in this mode, but is a 16 bit register, so it is read as 8 bit value to match the timer2 arithmetic.
+ * OCR3B is double buffered in PWM mode and cannot be moved forward by 250 ticks, see startTimer2MillisCountdown().
+ */
+#define TIMER2_IS_TIMER3
+#define TIMSK2 TIMSK3
+#define TOIE2  TOIE3
+#define OCIE2B OCIE3B
+#define TIFR2  TIFR3
+#define OCF2B  OCF3B
+#define TCNT2  ((uint8_t) TCNT3) // read only
+#define OCR2B  OCR3B
+#define TIMER2_COMPB_vect TIMER3_COMPB_vect
+#define TOV2   TOV3
+#endif
+
+#endif // TIMER2ALIAS_H_
@@ -46,6 +46,8 @@
 #define MAX_ADC_EXTERNAL_CHANNEL 4 // 5 channels 0-4, since ADC5/PC5 is used for AC/DC switching
 #ifdef AVR
 #define ADC_CHANNEL_COUNT ((MAX_ADC_EXTERNAL_CHANNEL + 1) + 2) // The number of external and internal ADC channels
+#define ADC_TEMPERATURE_CHANNEL 8
+#define ADC_1_1_VOLT_CHANNEL 0x0E
 #else
 #define START_ADC_CHANNEL_INDEX 0  // see also ChannelSelectButtonString
 #ifdef STM32F303xC
@@ -86,7 +88,8 @@ extern const char * const ChannelDivByButtonStrings[NUMBER_OF_CHANNELS_WITH_FIXE
 
 #define ADC_PRESCALE_MAX_VALUE ADC_PRESCALE128
 #define ADC_PRESCALE_START_VALUE ADC_PRESCALE128
-#define ADC_PRESCALE_FOR_TRIGGER_SEARCH ADC_PRESCALE8
+#define ADC_PRESCALE_FOR_TRIGGER_SEARCH ADC_PRESCALE8 // fastest trigger search, slower timebases use a slower one
+#define TRIGGER_SEARCH_CONVERSIONS_PER_SAMPLE 4 // minimum trigger search conversions per sample period -> 4 to 8
 
 #define TIMER0_PRESCALE0    1
 #define TIMER0_PRESCALE8    2
@@ -121,13 +124,7 @@ extern const char * const ChannelDivByButtonStrings[NUMBER_OF_CHANNELS_WITH_FIXE
 #define HORIZONTAL_GRID_HEIGHT_2V_SHIFT8 6554 // 25.6*256 for 0.05 to 0.2 volt/div for 10 divs per screen
 #define ADC_CYCLES_PER_CONVERSION 13
 #define TIMING_GRID_WIDTH 31 // with 31 instead of 32 the values fit better to 1-2-5 timebase scale
-#define TIMEBASE_NUMBER_OF_ENTRIES 15 // the number of different timebases provided
-#define TIMEBASE_NUMBER_OF_FAST_PRESCALE 8 // the number of prescale values not equal slowest possible prescale (PRESCALE128)
-#define TIMEBASE_NUMBER_OF_FAST_MODES 5 // first 5 timebase (10 - 201) are fast free running modes with polling instead of ISR using PRESCALE4 + PRESCALE8
-#define TIMEBASE_INDEX_ULTRAFAST_MODES 2 // first 3 timebase (10 - 50) using PRESCALE4 is ultra fast polling without preprocessing and therefore needs double buffer size
-#define TIMEBASE_NUMBER_OF_XSCALE_CORRECTION 4  // number of timebase which are simulated by display XSale factor. Since PRESCALE4 gives bad quality, use PRESCALE8 and XScale for 201 us range
-#define TIMEBASE_INDEX_MILLIS 6 // min index to switch to ms instead of us display
-#define TIMEBASE_INDEX_DRAW_WHILE_ACQUIRE 11 // min index where chart is drawn while buffer is filled (11 => 50 ms)
+#define TIMEBASE_NUMBER_OF_ENTRIES 18 // the number of different timebases provided. Properties of each timebase are in TimebaseDescriptors[]
 #else
 /*
  * TIMEBASE
@@ -152,7 +149,6 @@ extern const char * const ChannelDivByButtonStrings[NUMBER_OF_CHANNELS_WITH_FIXE
 #define TIMEBASE_INDEX_MICROS 2 // min index to switch to us instead of ns display
 #endif
 
-extern const float TimebaseExactDivValuesMicros[] PROGMEM;
 #define HORIZONTAL_LINE_LABELS_CAPION_X (REMOTE_DISPLAY_WIDTH - TEXT_SIZE_11_WIDTH * 4)
 /*
  * OFFSET
@@ -285,6 +281,20 @@ extern BDButton TouchButtonStartStopDSOMeasurement;
 extern BDButton TouchButtonSlope;
 extern BDButton TouchButtonTriggerMode;
 extern BDButton TouchButtonTriggerDelay;
+#ifdef AVR
+extern BDButton TouchButtonSamplePeriod;
+extern BDButton TouchButtonSequence;
+extern BDButton TouchButtonDataLoggerPage;
+extern BDButton TouchButtonDataLoggerStartStop;
+extern BDButton TouchButtonDataLoggerInterval;
+extern BDButton TouchButtonDataLoggerChannels[ADC_CHANNEL_COUNT];
+extern BDButton TouchButtonTrendPage;
+extern BDButton TouchButtonTrendClear;
+extern BDButton TouchButtonTrendInterval;
+extern BDButton TouchButtonReferencePage;
+extern BDButton TouchButtonReferenceStore[];
+extern BDButton TouchButtonReferenceShow[];
+#endif
 extern BDButton TouchButtonChartHistoryOnOff;
 extern BDButton TouchButtonSlope;
 extern BDButton TouchButtonAcDc;
@@ -341,6 +351,7 @@ int changeOffsetGridCount(int aValue);
 #ifdef AVR
 uint8_t changeRange(int8_t aChangeAmount);
 uint8_t changeTimeBaseValue(int8_t aChangeValue);
+void setUserSamplePeriod(uint32_t aSamplePeriodMicros);
 #else
 int changeDisplayRangeAndAdjustOffsetGridCount(int aValue);
 int changeTimeBaseValue(int aChangeValue);
@@ -355,6 +366,11 @@ void redrawDisplay(void);
 void drawStartPage(void);
 void drawDSOSettingsPage(void);
 void drawDSOMoreSettingsPage(void);
+#ifdef AVR
+void drawDataLoggerPage(void);
+void drawTrendPage(void);
+void drawReferencePage(void);
+#endif
 
 void drawGridLinesWithHorizLabelsAndTriggerLine();
 void clearHorizontalLineAndRestoreGrid(int aYposition);
@@ -387,10 +403,27 @@ void doSwitchInfoModeOnTouchUp(struct TouchEvent * const aTochPosition);
 void doLongTouchDownDSO(struct TouchEvent * const aTochPosition);
 void doSwipeEndDSO(struct Swipe * const aSwipeInfo);
 void doSetTriggerDelay(float aValue);
+#ifdef AVR
+void doSetSamplePeriod(float aValue);
+void doSetDataLoggerInterval(float aValue);
+void doSetTrendInterval(float aValue);
+#endif
 
 // Button handler section
 #ifdef AVR
 void doADCReference(BDButton * aTheTouchedButton, int16_t aValue);
+void doPromptForSamplePeriod(BDButton * aTheTouchedButton, int16_t aValue);
+void doStartSequence(BDButton * aTheTouchedButton, int16_t aValue);
+void doShowDataLoggerPage(BDButton * aTheTouchedButton, int16_t aValue);
+void doDataLoggerStartStop(BDButton * aTheTouchedButton, int16_t aValue);
+void doDataLoggerChannel(BDButton * aTheTouchedButton, int16_t aValue);
+void doPromptForDataLoggerInterval(BDButton * aTheTouchedButton, int16_t aValue);
+void doShowTrendPage(BDButton * aTheTouchedButton, int16_t aValue);
+void doClearTrend(BDButton * aTheTouchedButton, int16_t aValue);
+void doPromptForTrendInterval(BDButton * aTheTouchedButton, int16_t aValue);
+void doShowReferencePage(BDButton * aTheTouchedButton, int16_t aValue);
+void doStoreReference(BDButton * aTheTouchedButton, int16_t aValue);
+void doShowReference(BDButton * aTheTouchedButton, int16_t aValue);
 #else
 void doShowPretriggerValuesOnOff(BDButton * aTheTouchedButton, int16_t aValue);
 void doShowFFT(BDButton * aTheTouchedButton, int16_t aValue);
@@ -425,6 +458,9 @@ void doVoltagePicker(BDSlider * aTheTouchedSlider, uint16_t aValue);
 
 // Button caption section
 #ifdef AVR
+void setSamplePeriodButtonCaption(void);
+void setDataLoggerIntervalButtonCaption(void);
+void setTrendIntervalButtonCaption(void);
 #else
 void setMinMaxModeButtonCaption(void);
 #endif
@@ -383,7 +383,7 @@ void setTriggerLevelAndHysteresis(int aRawTriggerValue, int aRawTriggerHysteresi
  * uses MeasurementControl.DisplayRangeIndex for getRawOffsetValueFromGridCount()
  */
 void setACMode(bool aNewACMode) {
-#ifdef AVR
+#if defined(AVR) && !defined(USE_REMOTE_LAYERS)
     if (MeasurementControl.isRunning) {
         //clear old grid, since it will be changed
         BlueDisplay1.clearDisplay(COLOR_BACKGROUND_DSO);
@@ -498,6 +498,27 @@ BDButton TouchButtonStartStopDSOMeasurement;
 
 BDButton TouchButtonTriggerMode;
 BDButton TouchButtonTriggerDelay;
+#ifdef AVR
+BDButton TouchButtonSamplePeriod;
+BDButton TouchButtonSequence;
+
+#ifdef SUPPORT_DATA_LOGGER
+BDButton TouchButtonDataLoggerPage;
+BDButton TouchButtonDataLoggerStartStop;
+BDButton TouchButtonDataLoggerInterval;
+BDButton TouchButtonDataLoggerChannels[ADC_CHANNEL_COUNT];
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+BDButton TouchButtonTrendPage;
+BDButton TouchButtonTrendClear;
+BDButton TouchButtonTrendInterval;
+#endif
+
+BDButton TouchButtonReferencePage;
+BDButton TouchButtonReferenceStore[REFERENCE_SLOT_COUNT];
+BDButton TouchButtonReferenceShow[REFERENCE_SLOT_COUNT];
+#endif
 BDButton TouchButtonChartHistoryOnOff;
 BDButton TouchButtonSlope;
 char SlopeButtonString[] = "Slope\nascending";
@@ -565,6 +586,16 @@ void initDSOGUI(void) {
 // Button for Singleshot
     TouchButtonSingleshot.init(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, START_PAGE_BUTTON_HEIGHT,
     COLOR_GUI_CONTROL, F("Singleshot"), TEXT_SIZE_14, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doStartSingleshot);
+#ifdef AVR
+// Buttons for trend and reference page
+#ifdef SUPPORT_TREND_RECORDER
+    TouchButtonTrendPage.init(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_6, START_PAGE_BUTTON_HEIGHT, COLOR_GUI_CONTROL,
+            F("Trend"), TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doShowTrendPage);
+#endif
+    TouchButtonReferencePage.init(BUTTON_WIDTH_3_POS_2 + BUTTON_WIDTH_3 - BUTTON_WIDTH_6, tPosY, BUTTON_WIDTH_6,
+            START_PAGE_BUTTON_HEIGHT, COLOR_GUI_CONTROL, F("Ref."), TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0,
+            &doShowReferencePage);
+#endif
 
 // 2. row
     tPosY += START_PAGE_ROW_INCREMENT;
@@ -584,7 +615,13 @@ void initDSOGUI(void) {
 
 // 4. row
     tPosY += 2 * START_PAGE_ROW_INCREMENT;
-#ifndef AVR
+#ifdef AVR
+// Button for data logger page
+#ifdef SUPPORT_DATA_LOGGER
+    TouchButtonDataLoggerPage.init(0, tPosY, BUTTON_WIDTH_3, START_PAGE_BUTTON_HEIGHT, COLOR_GUI_CONTROL, F("Data\nlogger"),
+    TEXT_SIZE_14, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doShowDataLoggerPage);
+#endif
+#else
 // Button for show FFT - only for Start and Chart pages
     TouchButtonFFT.init(0, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_4, COLOR_GREEN, "FFT",
             TEXT_SIZE_22, FLAG_BUTTON_DO_BEEP_ON_TOUCH | FLAG_BUTTON_TYPE_TOGGLE_RED_GREEN_MANUAL_REFRESH, DisplayControl.ShowFFT,
@@ -648,7 +685,11 @@ void initDSOGUI(void) {
 // 3. row
     tPosY += SETTINGS_PAGE_ROW_INCREMENT;
 
-#ifndef AVR
+#ifdef AVR
+// Button for user sample period
+    TouchButtonSamplePeriod.init(0, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT, COLOR_GUI_SOURCE_TIMEBASE, "",
+    TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doPromptForSamplePeriod);
+#else
 // Button for pretrigger area show
 #ifdef LOCAL_DISPLAY_EXISTS
     TouchButtonShowPretriggerValuesOnOff.init(SLIDER_DEFAULT_BAR_WIDTH + 6, tPosY,
@@ -680,7 +721,11 @@ void initDSOGUI(void) {
 // 4. row
     tPosY += SETTINGS_PAGE_ROW_INCREMENT;
 
-#ifndef AVR
+#ifdef AVR
+// Button for sequence of single shots
+    TouchButtonSequence.init(0, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT, COLOR_GUI_CONTROL, F("Sequence\nof shots"),
+    TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doStartSequence);
+#else
 // Button for min/max acquisition mode
 #ifdef LOCAL_DISPLAY_EXISTS
     TouchButtonMinMaxMode.init(SLIDER_DEFAULT_BAR_WIDTH + 6, tPosY, BUTTON_WIDTH_3 - (SLIDER_DEFAULT_BAR_WIDTH + 6),
@@ -724,6 +769,59 @@ void initDSOGUI(void) {
 // Button for reference voltage switching
     TouchButtonADCReference.init(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT,
     COLOR_GUI_SOURCE_TIMEBASE, "", TEXT_SIZE_18, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doADCReference);
+
+#ifdef SUPPORT_DATA_LOGGER
+    /***************************
+     * Data logger page
+     ***************************/
+// 1. row
+    tPosY = 0;
+    TouchButtonDataLoggerStartStop.init(0, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT, BUTTON_AUTO_RED_GREEN_FALSE_COLOR,
+            F("Logger"), TEXT_SIZE_18, FLAG_BUTTON_DO_BEEP_ON_TOUCH | FLAG_BUTTON_TYPE_TOGGLE_RED_GREEN, 0, &doDataLoggerStartStop);
+
+    TouchButtonDataLoggerInterval.init(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT,
+    COLOR_GUI_SOURCE_TIMEBASE, "", TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doPromptForDataLoggerInterval);
+    setDataLoggerIntervalButtonCaption();
+    // Back button is the one of settings page
+
+// 2. row
+    tPosY += SETTINGS_PAGE_ROW_INCREMENT;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; ++i) {
+        TouchButtonDataLoggerChannels[i].init(i * (REMOTE_DISPLAY_WIDTH / ADC_CHANNEL_COUNT), tPosY, BUTTON_WIDTH_6,
+        SETTINGS_PAGE_BUTTON_HEIGHT, BUTTON_AUTO_RED_GREEN_FALSE_COLOR,
+                reinterpret_cast<const __FlashStringHelper *>(ADCInputMUXChannelStrings[i]), TEXT_SIZE_11,
+                FLAG_BUTTON_DO_BEEP_ON_TOUCH | FLAG_BUTTON_TYPE_TOGGLE_RED_GREEN, (DataLogger.ChannelMask & _BV(i)) != 0,
+                &doDataLoggerChannel);
+    }
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+    /***************************
+     * Trend page
+     ***************************/
+// 1. row
+    tPosY = 0;
+    TouchButtonTrendClear.init(0, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT, COLOR_GUI_CONTROL, F("Clear"),
+    TEXT_SIZE_18, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doClearTrend);
+
+    TouchButtonTrendInterval.init(BUTTON_WIDTH_3_POS_2, tPosY, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT,
+    COLOR_GUI_SOURCE_TIMEBASE, "", TEXT_SIZE_11, FLAG_BUTTON_DO_BEEP_ON_TOUCH, 0, &doPromptForTrendInterval);
+    setTrendIntervalButtonCaption();
+    // Back button is the one of settings page
+#endif
+
+    /***************************
+     * Reference page
+     ***************************/
+// 2. row store buttons have the color of the reference, 3. row show buttons
+    for (uint8_t i = 0; i < REFERENCE_SLOT_COUNT; ++i) {
+        uint16_t tPosX = i * BUTTON_WIDTH_3_POS_2;
+        TouchButtonReferenceStore[i].init(tPosX, SETTINGS_PAGE_ROW_INCREMENT, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT,
+                pgm_read_word(&ReferenceColors[i]), F("Store"), TEXT_SIZE_18, FLAG_BUTTON_DO_BEEP_ON_TOUCH, i, &doStoreReference);
+        TouchButtonReferenceShow[i].init(tPosX, 2 * SETTINGS_PAGE_ROW_INCREMENT, BUTTON_WIDTH_3, SETTINGS_PAGE_BUTTON_HEIGHT,
+                BUTTON_AUTO_RED_GREEN_FALSE_COLOR, F("Show"), TEXT_SIZE_18,
+                FLAG_BUTTON_DO_BEEP_ON_TOUCH | FLAG_BUTTON_TYPE_TOGGLE_RED_GREEN, 0, &doShowReference);
+    }
 #else
 // Button for more-settings pages
     TouchButtonDSOMoreSettings.init(BUTTON_WIDTH_3_POS_3, tPosY, BUTTON_WIDTH_3, BUTTON_HEIGHT_5,
@@ -812,12 +910,20 @@ void redrawDisplay() {
         /*
          * running mode
          */
+#ifdef MEASURE_ISR_TIMING
+        if (DisplayControl.DisplayPage == DISPLAY_PAGE_ISR_TIMING) {
+            drawISRTimingPage();
+        } else
+#endif
         if (DisplayControl.DisplayPage >= DISPLAY_PAGE_SETTINGS) {
             drawDSOSettingsPage();
         } else {
             activateChartGui();
             // refresh grid - not really needed, since after MILLIS_BETWEEN_INFO_OUTPUT it is done by loop
             drawGridLinesWithHorizLabelsAndTriggerLine();
+#ifdef AVR
+            drawReferenceCharts();
+#endif
             printInfo();
 #ifndef AVR
             TouchButtonChartHistoryOnOff.activate(); //???
@@ -837,6 +943,7 @@ void redrawDisplay() {
             drawMinMaxLines();
             // draw from last scroll position
 #ifdef AVR
+            drawReferenceCharts();
             drawDataBuffer(DataBufferControl.DataBufferDisplayStart, COLOR_DATA_HOLD, DisplayControl.EraseColor);
 #else
             drawDataBuffer(DataBufferControl.DataBufferDisplayStart, REMOTE_DISPLAY_WIDTH, COLOR_DATA_HOLD, 0,
@@ -845,6 +952,22 @@ void redrawDisplay() {
             printInfo();
         } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS) {
             drawDSOSettingsPage();
+#ifdef AVR
+#ifdef SUPPORT_DATA_LOGGER
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_DATA_LOGGER) {
+            drawDataLoggerPage();
+#endif
+#ifdef SUPPORT_TREND_RECORDER
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_TREND) {
+            drawTrendPage();
+#endif
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_REFERENCE) {
+            drawReferencePage();
+#endif
+#ifdef MEASURE_ISR_TIMING
+        } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_ISR_TIMING) {
+            drawISRTimingPage();
+#endif
         }
     }
 }
@@ -852,6 +975,12 @@ void redrawDisplay() {
 void drawStartPage(void) {
 //1. Row
     TouchButtonChartHistoryOnOff.drawButton();
+#ifdef AVR
+#ifdef SUPPORT_TREND_RECORDER
+    TouchButtonTrendPage.drawButton();
+#endif
+    TouchButtonReferencePage.drawButton();
+#endif
     TouchButtonSingleshot.drawButton();
 //2. Row
 #ifdef LOCAL_FILESYSTEM_EXISTS
@@ -860,7 +989,11 @@ void drawStartPage(void) {
 #endif
     TouchButtonStartStopDSOMeasurement.drawButton();
 // 4. Row
-#ifndef AVR
+#ifdef AVR
+#ifdef SUPPORT_DATA_LOGGER
+    TouchButtonDataLoggerPage.drawButton();
+#endif
+#else
     TouchButtonFFT.drawButton();
 #endif
     TouchButtonSettingsPage.drawButton();
@@ -887,6 +1020,69 @@ void drawStartPage(void) {
 #endif
 }
 
+#ifdef AVR
+#ifdef SUPPORT_DATA_LOGGER
+/**
+ * draws elements active for data logger page
+ */
+void drawDataLoggerPage(void) {
+    TouchButtonDataLoggerStartStop.setValueAndDraw(DataLogger.isRunning);
+    TouchButtonDataLoggerInterval.drawButton();
+    TouchButtonBack.drawButton();
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; ++i) {
+        TouchButtonDataLoggerChannels[i].setValueAndDraw((DataLogger.ChannelMask & _BV(i)) != 0);
+    }
+}
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+/**
+ * draws trend chart and elements active for trend page
+ */
+void drawTrendPage(void) {
+    drawTrendChart();
+    TouchButtonTrendClear.drawButton();
+    TouchButtonTrendInterval.drawButton();
+    TouchButtonBack.drawButton();
+}
+#endif
+
+/**
+ * draws elements active for reference page
+ */
+void drawReferencePage(void) {
+    TouchButtonBack.drawButton();
+    for (uint8_t i = 0; i < REFERENCE_SLOT_COUNT; ++i) {
+        TouchButtonReferenceStore[i].drawButton();
+        TouchButtonReferenceShow[i].setValueAndDraw((DisplayControl.ReferenceShowMask & _BV(i)) != 0);
+    }
+    BlueDisplay1.drawText(0, TEXT_SIZE_11_ASCEND, F("Reference\nwaveforms"), TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    BlueDisplay1.drawText(0, 3 * SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_ASCEND,
+            F("Store saves the displayed chart in EEPROM.\nShow draws it over the chart."), TEXT_SIZE_11, COLOR_BLACK,
+            COLOR_BACKGROUND_DSO);
+}
+
+#ifdef MEASURE_ISR_TIMING
+/**
+ * draws labels and histograms for ISR timing page
+ */
+void drawISRTimingPage(void) {
+    TouchButtonBack.drawButton();
+    BlueDisplay1.drawText(0, TEXT_SIZE_11_ASCEND, F("ISR timing\nLong touch sends to host"), TEXT_SIZE_11, COLOR_BLACK,
+    COLOR_BACKGROUND_DSO);
+    BlueDisplay1.drawText(BUTTON_WIDTH_3_POS_2, SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_ASCEND, F("Latency cycles"),
+    TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    BlueDisplay1.drawText(BUTTON_WIDTH_3_POS_3, SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_ASCEND, F("Duration 4us"),
+    TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    BlueDisplay1.drawText(0, SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_HEIGHT + TEXT_SIZE_11_ASCEND, F("ADC"), TEXT_SIZE_11,
+    COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    BlueDisplay1.drawText(0, 2 * SETTINGS_PAGE_ROW_INCREMENT + TEXT_SIZE_11_HEIGHT + TEXT_SIZE_11_ASCEND, F("Timer1 OVF"),
+    TEXT_SIZE_11, COLOR_BLACK, COLOR_BACKGROUND_DSO);
+    printISRTimingHistograms();
+}
+#endif
+#endif
+
 /**
  * draws elements active for settings page
  */
@@ -922,7 +1118,9 @@ void drawDSOSettingsPage(void) {
     TouchButtonChannelSelect.setButtonColorAndDraw(tButtonColor);
 
 //3. Row
-#ifndef AVR
+#ifdef AVR
+    setSamplePeriodButtonCaption(); // also draws the button for this page
+#else
     TouchButtonShowPretriggerValuesOnOff.drawButton();
 #endif
     TouchButtonAutoRangeOnOff.drawButton();
@@ -934,7 +1132,10 @@ void drawDSOSettingsPage(void) {
     TouchButtonChannelSelect.drawButton();
 
 // 4. Row
-#ifndef AVR
+#ifdef AVR
+    TouchButtonSequence.drawButton();
+    printTriggerStatistics();
+#else
     TouchButtonMinMaxMode.drawButton();
 #endif
     TouchButtonAutoOffsetMode.drawButton();
@@ -1029,8 +1230,10 @@ void drawRunningOnlyPartOfGui(void) {
 }
 
 void clearTriggerLine(uint8_t aTriggerLevelDisplayValue) {
-// clear old line
+// clear old line, with remote layers this is done by drawTriggerLine() which clears the whole layer
+#ifndef USE_REMOTE_LAYERS
     clearHorizontalLineAndRestoreGrid(aTriggerLevelDisplayValue);
+#endif
 
 #ifndef AVR
     if (!MeasurementControl.isRunning) {
@@ -1052,8 +1255,17 @@ void clearTriggerLine(uint8_t aTriggerLevelDisplayValue) {
  */
 void drawTriggerLine(void) {
     uint8_t tValue = DisplayControl.TriggerLevelDisplayValue;
+#ifdef USE_REMOTE_LAYERS
+    BlueDisplay1.clearLayer(DSO_LAYER_TRIGGER_LINE);
+#endif
     if (tValue != 0 && MeasurementControl.TriggerMode < TRIGGER_MODE_FREE) {
+#ifdef USE_REMOTE_LAYERS
+        BlueDisplay1.setDrawLayer(DSO_LAYER_TRIGGER_LINE);
+        BlueDisplay1.drawLineRel(0, tValue, REMOTE_DISPLAY_WIDTH, 0, COLOR_TRIGGER_LINE);
+        BlueDisplay1.setDrawLayer(DSO_LAYER_DEFAULT);
+#else
         BlueDisplay1.drawLineRel(0, tValue, REMOTE_DISPLAY_WIDTH, 0, COLOR_TRIGGER_LINE);
+#endif
     }
 }
 
@@ -1093,6 +1305,10 @@ void drawGridLinesWithHorizLabelsAndTriggerLine() {
     if (DisplayControl.DisplayPage != DISPLAY_PAGE_CHART) {
         return;
     }
+#ifdef USE_REMOTE_LAYERS
+    BlueDisplay1.clearLayer(DSO_LAYER_GRID);
+    BlueDisplay1.setDrawLayer(DSO_LAYER_GRID);
+#endif
 // vertical (timing) lines
     for (unsigned int tXPos = TIMING_GRID_WIDTH - 1; tXPos < REMOTE_DISPLAY_WIDTH; tXPos += TIMING_GRID_WIDTH) {
         BlueDisplay1.drawLineRel(tXPos, 0, 0, REMOTE_DISPLAY_HEIGHT, COLOR_GRID_LINES);
@@ -1198,6 +1414,9 @@ void drawGridLinesWithHorizLabelsAndTriggerLine() {
         tCaptionOffset = -(TEXT_SIZE_11_ASCEND / 2);
         tActualVoltage += ScaleVoltagePerDiv[MeasurementControl.DisplayRangeIndexForPrint];
     }
+#endif
+#ifdef USE_REMOTE_LAYERS
+    BlueDisplay1.setDrawLayer(DSO_LAYER_DEFAULT);
 #endif
     drawTriggerLine();
 }
@@ -1294,6 +1513,30 @@ void setTriggerDelayCaption(void) {
     TouchButtonTriggerDelay.setCaption(sStringBuffer, (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS));
 }
 
+void setSamplePeriodButtonCaption(void) {
+    if (MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_USER_SAMPLE_PERIOD) {
+        uint32_t tSamplePeriodMicros = (MeasurementControl.TimebaseDescriptor.ExactDivMicros / TIMING_GRID_WIDTH) + 0.5;
+        sprintf_P(sStringBuffer, PSTR("Sample\n%lu\xB5s"), tSamplePeriodMicros);
+    } else {
+        strcpy_P(sStringBuffer, PSTR("Sample\nperiod"));
+    }
+    TouchButtonSamplePeriod.setCaption(sStringBuffer, (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS));
+}
+
+#ifdef SUPPORT_DATA_LOGGER
+void setDataLoggerIntervalButtonCaption(void) {
+    sprintf_P(sStringBuffer, PSTR("Interval\n%u s"), DataLogger.IntervalSeconds);
+    TouchButtonDataLoggerInterval.setCaption(sStringBuffer, (DisplayControl.DisplayPage == DISPLAY_PAGE_DATA_LOGGER));
+}
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+void setTrendIntervalButtonCaption(void) {
+    sprintf_P(sStringBuffer, PSTR("Interval\n%u s"), TrendRecorder.IntervalSeconds);
+    TouchButtonTrendInterval.setCaption(sStringBuffer, (DisplayControl.DisplayPage == DISPLAY_PAGE_TREND));
+}
+#endif
+
 void setReferenceButtonCaption(void) {
     const char * tCaption;
     if (MeasurementControl.ADCReference == DEFAULT) {
@@ -1367,6 +1610,7 @@ void doSwitchInfoModeOnTouchUp(struct TouchEvent * const aTouchPosition) {
 /*
  * If stopped toggle between Start and Chart page
  * If running toggle between gui display and chart only
+ * At settings page send event trace to host if TRACE_EVENTS is active and show ISR timing page if MEASURE_ISR_TIMING is active
  */
 void doLongTouchDownDSO(struct TouchEvent * const aTochPosition) {
     static bool sIsGUIVisible = false;
@@ -1389,6 +1633,20 @@ void doLongTouchDownDSO(struct TouchEvent * const aTochPosition) {
         // only chart (and voltage picker)
         DisplayControl.DisplayPage = DISPLAY_PAGE_CHART;
         redrawDisplay();
+#if defined(TRACE_EVENTS) || defined(MEASURE_ISR_TIMING)
+    } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_SETTINGS) {
+#  ifdef TRACE_EVENTS
+        dumpTraceBuffer();
+#  endif
+#  ifdef MEASURE_ISR_TIMING
+        DisplayControl.DisplayPage = DISPLAY_PAGE_ISR_TIMING;
+        redrawDisplay();
+#  endif
+#endif
+#ifdef MEASURE_ISR_TIMING
+    } else if (DisplayControl.DisplayPage == DISPLAY_PAGE_ISR_TIMING) {
+        sendISRTiming();
+#endif
     }
 }
 
@@ -1538,6 +1796,9 @@ void doOffsetMode(BDButton * aTheTouchedButton, int16_t aValue) {
         setAutoRangeModeAndButtonCaption(true);
 #ifdef AVR
         MeasurementControl.OffsetValue = 0;
+#ifdef ISR_STATE_IN_GPIOR
+        loadISRStateRegisters();
+#endif
 #else
         setOffsetGridCountAccordingToACMode();
 
@@ -1631,6 +1892,7 @@ void doChartHistory(BDButton * aTheTouchedButton, int16_t aValue) {
 void doStartSingleshot(BDButton * aTheTouchedButton, int16_t aValue) {
     aTheTouchedButton->deactivate();
     MeasurementControl.isSingleShotMode = true;
+    MeasurementControl.SequenceNumberOfShots = 0;
 
     DisplayControl.DisplayPage = DISPLAY_PAGE_CHART;
 
@@ -1651,6 +1913,37 @@ void doStartSingleshot(BDButton * aTheTouchedButton, int16_t aValue) {
 #endif
 }
 
+#ifdef AVR
+/*
+ * Start a sequence of single shots. Each shot gets one screen of the data buffer
+ * and the next shot is armed directly after the previous one without drawing.
+ * Flip through the shots by swiping the chart afterwards.
+ */
+void doStartSequence(__attribute__((unused)) BDButton * aTheTouchedButton, __attribute__((unused)) int16_t aValue) {
+    MeasurementControl.isSingleShotMode = true;
+    MeasurementControl.SequenceNumberOfShots = SEQUENCE_NUMBER_OF_SHOTS_MAX;
+    if (MeasurementControl.TimebaseDescriptor.Flags & TIMEBASE_FLAG_ULTRAFAST_MODE) {
+        // ultra fast mode needs 2 bytes per sample while acquiring
+        MeasurementControl.SequenceNumberOfShots = SEQUENCE_NUMBER_OF_SHOTS_MAX - 1;
+    }
+    MeasurementControl.SequenceShotIndex = 0;
+
+    DisplayControl.DisplayPage = DISPLAY_PAGE_CHART;
+
+    MeasurementControl.RawValueMax = 0;
+    MeasurementControl.RawValueMin = 0;
+
+    clearDisplayAndDisableButtonsAndSliders(COLOR_BACKGROUND_DSO);
+    activateChartGui();
+    drawGridLinesWithHorizLabelsAndTriggerLine();
+    DataBufferControl.DataBufferDisplayStart = &DataBufferControl.DataBuffer[0];
+    MeasurementControl.StopRequested = true;
+    startAcquisition();
+    MeasurementControl.isRunning = true;
+    printSingleshotMarker();
+}
+#endif
+
 /*
  * Slider is only activated if trigger mode == TRIGGER_MODE_MANUAL_TIMEOUT or TRIGGER_MODE_MANUAL
  */
@@ -1686,7 +1979,11 @@ void doVoltagePicker(BDSlider * aTheTouchedSlider, uint16_t aValue) {
     }
 // clear old line
     int tYpos = DISPLAY_VALUE_FOR_ZERO - sLastPickerValue;
+#ifdef USE_REMOTE_LAYERS
+    BlueDisplay1.clearLayer(DSO_LAYER_VOLTAGE_PICKER);
+#else
     clearHorizontalLineAndRestoreGrid(tYpos);
+#endif
 
 #ifndef AVR
     if (!MeasurementControl.isRunning) {
@@ -1710,7 +2007,13 @@ void doVoltagePicker(BDSlider * aTheTouchedSlider, uint16_t aValue) {
 
 // draw new line
     int tValue = DISPLAY_VALUE_FOR_ZERO - aValue;
+#ifdef USE_REMOTE_LAYERS
+    BlueDisplay1.setDrawLayer(DSO_LAYER_VOLTAGE_PICKER);
     BlueDisplay1.drawLine(0, tValue, REMOTE_DISPLAY_WIDTH, tValue, COLOR_VOLTAGE_PICKER);
+    BlueDisplay1.setDrawLayer(DSO_LAYER_DEFAULT);
+#else
+    BlueDisplay1.drawLine(0, tValue, REMOTE_DISPLAY_WIDTH, tValue, COLOR_VOLTAGE_PICKER);
+#endif
     sLastPickerValue = aValue;
 
     float tVoltage = getFloatFromDisplayValue(tValue);
@@ -1741,6 +2044,95 @@ void doPromptForTriggerDelay(BDButton * aTheTouchedButton, int16_t aValue) {
     BlueDisplay1.getNumberWithShortPrompt(&doSetTriggerDelay, F("Trigger delay [\xB5s]"));
 }
 
+void doPromptForSamplePeriod(BDButton * aTheTouchedButton, int16_t aValue) {
+    BlueDisplay1.getNumberWithShortPrompt(&doSetSamplePeriod, F("Sample period [\xB5s]"));
+}
+
+#ifdef SUPPORT_DATA_LOGGER
+void doPromptForDataLoggerInterval(BDButton * aTheTouchedButton, int16_t aValue) {
+    BlueDisplay1.getNumberWithShortPrompt(&doSetDataLoggerInterval, F("Log interval [s]"));
+}
+
+void doShowDataLoggerPage(BDButton * aTheTouchedButton, int16_t aValue) {
+    DisplayControl.DisplayPage = DISPLAY_PAGE_DATA_LOGGER;
+    redrawDisplay();
+}
+
+void doDataLoggerStartStop(BDButton * aTheTouchedButton, int16_t aValue) {
+    if (aValue) {
+        startDataLogger();
+    } else {
+        stopDataLogger();
+    }
+}
+
+/*
+ * Toggle channel in scan set. The last selected channel cannot be deselected.
+ */
+void doDataLoggerChannel(BDButton * aTheTouchedButton, int16_t aValue) {
+    // the value is used for toggling, so get channel from button
+    uint8_t tChannelIndex = 0;
+    while (!(*aTheTouchedButton == TouchButtonDataLoggerChannels[tChannelIndex])) {
+        tChannelIndex++;
+    }
+    uint8_t tNewMask = DataLogger.ChannelMask & ~_BV(tChannelIndex);
+    if (aValue) {
+        resetDataLoggerChannel(tChannelIndex);
+        tNewMask |= _BV(tChannelIndex);
+    } else if (tNewMask == 0) {
+        BlueDisplay1.playFeedbackTone(FEEDBACK_TONE_ERROR);
+        aTheTouchedButton->setValueAndDraw(true);
+        return;
+    }
+    DataLogger.ChannelMask = tNewMask;
+}
+#endif
+
+#ifdef SUPPORT_TREND_RECORDER
+void doPromptForTrendInterval(BDButton * aTheTouchedButton, int16_t aValue) {
+    BlueDisplay1.getNumberWithShortPrompt(&doSetTrendInterval, F("Trend interval [s]"));
+}
+
+void doShowTrendPage(BDButton * aTheTouchedButton, int16_t aValue) {
+    DisplayControl.DisplayPage = DISPLAY_PAGE_TREND;
+    redrawDisplay();
+}
+
+void doClearTrend(BDButton * aTheTouchedButton, int16_t aValue) {
+    clearTrendRecorder();
+    redrawDisplay();
+}
+#endif
+
+void doShowReferencePage(BDButton * aTheTouchedButton, int16_t aValue) {
+    DisplayControl.DisplayPage = DISPLAY_PAGE_REFERENCE;
+    redrawDisplay();
+}
+
+/*
+ * aValue is the slot index
+ */
+void doStoreReference(BDButton * aTheTouchedButton, int16_t aValue) {
+    uint8_t tFeedbackType = FEEDBACK_TONE_ERROR;
+    if (storeReference(aValue)) {
+        tFeedbackType = FEEDBACK_TONE_OK;
+    }
+    BlueDisplay1.playFeedbackTone(tFeedbackType);
+}
+
+void doShowReference(BDButton * aTheTouchedButton, int16_t aValue) {
+    // the value is used for toggling, so get slot from button
+    uint8_t tSlot = 0;
+    while (tSlot < REFERENCE_SLOT_COUNT - 1 && !(*aTheTouchedButton == TouchButtonReferenceShow[tSlot])) {
+        tSlot++;
+    }
+    if (aValue) {
+        DisplayControl.ReferenceShowMask |= _BV(tSlot);
+    } else {
+        DisplayControl.ReferenceShowMask &= ~_BV(tSlot);
+    }
+}
+
 #else
 void doShowPretriggerValuesOnOff(BDButton * aTheTouchedButton, int16_t aValue) {
     DisplayControl.DatabufferPreTriggerDisplaySize = 0;
@@ -1844,8 +2236,8 @@ void doADS7846TestOnOff(BDButton * aTheTouchedButton, int16_t aValue) {
 
 uint32_t getMicrosFromHorizontalDisplayValue(uint16_t aDisplayValueHorizontal, uint8_t aNumberOfPeriods) {
 #ifdef AVR
-    // values in TimebaseExactDivValuesMicros are guaranteed to be multiple of 31 if index is greater than 4
-    uint32_t tMicros = aDisplayValueHorizontal * pgm_read_float(&TimebaseExactDivValuesMicros[MeasurementControl.TimebaseIndex]);
+    // values of ExactDivMicros are guaranteed to be multiple of 31 if not in fast mode
+    uint32_t tMicros = aDisplayValueHorizontal * MeasurementControl.TimebaseDescriptor.ExactDivMicros;
 #else
     uint32_t tMicros = aDisplayValueHorizontal * getDataBufferTimebaseExactValueMicros(MeasurementControl.TimebaseEffectiveIndex);
 #endif
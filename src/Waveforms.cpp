@@ -2,6 +2,14 @@
  * Waveforms.cpp
  *
  * Code uses 16 bit AVR Timer1 and generates a 62.5 kHz PWM signal with 8 Bit resolution.
+ * For smoother output of low frequencies, 9 bit with 31.25 kHz and 10 bit with 15.625 kHz PWM can be selected.
+ * Every bit more doubles the ISR period and the number of values of triangle and sawtooth,
+ * so maximum frequency is divided by 2 for sine and noise and by 4 for triangle and sawtooth:
+ *            8 bit           9 bit          10 bit
+ * SINE:      7812.5 Hz       3906.25 Hz     1953.125 Hz
+ * TRIANGLE:  1953.125 Hz     488.8 Hz       122.1 Hz
+ * SAWTOOTH:  3906.25 Hz      976.5625 Hz    244.14 Hz
+ * NOISE:     62.5 kHz        31.25 kHz      15.625 kHz
  * After every PWM cycle an interrupt handler sets a new PWM value, resulting in a sine, triangle or sawtooth output.
  * New value is taken by a rolling index from a table for sine, or directly computed from that index for triangle and sawtooth waveforms.
  *
@@ -12,6 +20,13 @@
  * By using a "floating point" index increment, every frequency lower than these maximum values can be generated.
  *
  * In CTC Mode Timer1 generates square wave from 0.119 Hz up to 8 MHz (full range of Timer1).
+ * In Fast PWM mode with OCR1A as TOP Timer1 generates pulses from 0.238 Hz up to 8 MHz with independent pulse width.
+ *
+ * PRBS: 16 bit maximal length LFSR sequence (65535 chips) with chip rate from 0.238 Hz up to 10 kHz.
+ * Compare match ISR sets the compare output mode for the next chip, so chips are switched jitter free by hardware.
+ * NOISE: LFSR values masked with PWMTop as PWM, at up to 62.5 kHz value rate for 8 bit resolution, 31.25 kHz for 9 and 15.625 kHz for 10 bit.
+ * RC filtered, it gives white noise up to the filter cutoff.
+ * DC: constant 10 bit PWM value without interrupt. Value is set by the closed loop control in FrequencyGeneratorPage.cpp.
  * Timer1 is used by Arduino for Servo Library. For 8 bit resolution it may also be possible to use Timer2 which is used for Arduino tone().
  *
  * Output is at PIN 10
@@ -43,6 +58,8 @@
 
 #include <Arduino.h>
 #include "Waveforms.h"
+#include "ISRTiming.h"
+#include "Timer2Alias.h" // TCNT2 for ISR timing
 
 #define TIMER_PRESCALER_MASK 0x07
 
@@ -55,28 +72,56 @@ struct FrequencyInfoStruct sFrequencyInfo;
 #define SIZE_OF_SINE_TABLE_QUARTER 32
 const uint8_t sSineTableQuarter128[SIZE_OF_SINE_TABLE_QUARTER + 1] PROGMEM = { 128, 135, 141, 147, 153, 159, 165, 171, 177, 182,
         188, 193, 199, 204, 209, 213, 218, 222, 226, 230, 234, 237, 240, 243, 245, 248, 250, 251, 253, 254, 254, 255, 255 };
+/*
+ * Same table for 10 bit PWM with values from 512 to 1023, shifted right by one for 9 bit PWM
+ */
+const uint16_t sSineTableQuarter512[SIZE_OF_SINE_TABLE_QUARTER + 1] PROGMEM = { 512, 537, 562, 587, 612, 636, 660, 684, 708, 730,
+        753, 775, 796, 816, 836, 855, 873, 891, 907, 922, 937, 950, 963, 974, 984, 993, 1001, 1008, 1013, 1017, 1021, 1022, 1023 };
 // Base period, for which exact one next value from table/computation is taken at every interrupt
 // 8 Bit PWM resolution gives 488.28125 Hz sine base frequency: 1/16 us * 256 * 128 = 16*128 = 2048 us = 488.28125 Hz
+// Values are for 8 bit PWM. For sine and noise they must be multiplied by (PWMTop + 1) / 256,
+// for triangle and sawtooth they are computed from PWMTop, since the number of values also increases.
 #define BASE_PERIOD_MICROS_FOR_SINE_TABLE 2048UL // ((1/F_CPU) * PWM_RESOLUTION) * (SIZE_OF_SINE_TABLE_QUARTER * 4)
-#define BASE_PERIOD_MICROS_FOR_TRIANGLE 8176UL // (1/F_CPU) * PWM_RESOLUTION * (256+255) Values -> 122.3092 Hz
 #define BASE_PERIOD_MICROS_FOR_SAWTOOTH 4096UL // (1/F_CPU) * PWM_RESOLUTION * 256 Values -> 244.140625 Hz
+#define BASE_PERIOD_MICROS_FOR_NOISE 16UL // (1/F_CPU) * PWM_RESOLUTION -> 62.5 kHz
+
+/*
+ * Galois LFSR with polynomial x^16 + x^14 + x^13 + x^11 + 1 gives maximal length sequence of 65535 bits.
+ * Value must never be 0.
+ */
+#define LFSR_TAPS 0xB400
+static uint16_t sLFSRValue = 1;
+
+/*
+ * The compare B ISR must run within one chip, otherwise the next chip repeats the current one and the sequence is corrupted.
+ * The longest ISR is the ADC ISR at the trigger of the 2 ms DSO range, which waits 47 us for the first sample.
+ * 100 us per chip leaves enough time for it and a USART receive ISR.
+ */
+#define PRBS_CHIP_RATE_MAX_HZ 10000L
 
 const char FrequencyFactorChars[4] = { 'm', ' ', 'k', 'M' };
 
 /*
- * 8-bit PWM Output at PIN 10
+ * 8, 9 or 10-bit PWM Output at PIN 10, depending on PWMResolutionShift
  * Overflow interrupt is generated every cycle -> this is used to generate the waveforms
  */
-void initTimer1For8BitPWM() {
+void initTimer1ForPWM() {
     DDRB |= _BV(DDB2); // set pin OC1B = PortB2 -> PIN 10 to output direction
 
-    TCCR1A = _BV(COM1B1) | _BV(WGM10); // Clear OC1B on Compare Match.  With WGM12 Waveform Generation Mode 5 - Fast PWM 8-bit,
-    //    TCCR1A = _BV(COM1A1) | _BV(COM1B1) | _BV(WGM11); // With WGM12 Waveform Generation Mode 6 - Fast PWM, 9-bit
-    //    TCCR1A = _BV(COM1A1) | _BV(COM1B1) | _BV(WGM11) | _BV(WGM10); // With WGM12 Waveform Generation Mode 7 - Fast PWM, 10-bit
+    if (sFrequencyInfo.PWMResolutionShift == PWM_RESOLUTION_SHIFT_10_BIT) {
+        TCCR1A = _BV(COM1B1) | _BV(WGM11) | _BV(WGM10); // With WGM12 Waveform Generation Mode 7 - Fast PWM, 10-bit
+        sFrequencyInfo.PWMTop = 0x3FF;
+    } else if (sFrequencyInfo.PWMResolutionShift == PWM_RESOLUTION_SHIFT_9_BIT) {
+        TCCR1A = _BV(COM1B1) | _BV(WGM11); // With WGM12 Waveform Generation Mode 6 - Fast PWM, 9-bit
+        sFrequencyInfo.PWMTop = 0x1FF;
+    } else {
+        TCCR1A = _BV(COM1B1) | _BV(WGM10); // Clear OC1B on Compare Match.  With WGM12 Waveform Generation Mode 5 - Fast PWM 8-bit,
+        sFrequencyInfo.PWMTop = 0xFF;
+    }
     TCCR1B = _BV(WGM12); // set OC1A/OC1B at BOTTOM (non-inverting mode) - no clock (prescaler) -> timer disabled now
 
-    OCR1A = 0xFF;   // output DC - HIGH
-    OCR1B = 0xFF;   // output DC - HIGH
+    OCR1A = sFrequencyInfo.PWMTop;   // output DC - HIGH
+    OCR1B = sFrequencyInfo.PWMTop;   // output DC - HIGH
     TCNT1 = 0;      // init counter
     TIMSK1 = _BV(TOIE1); // Enable Overflow Interrupt
 }
@@ -95,13 +140,64 @@ void initTimer1ForCTC(void) {
     TCNT1 = 0; // init counter
 }
 
+/*
+ * Fast PWM output at PIN 10 - OCR1A is TOP and determines the period, OCR1B determines the pulse width.
+ * Mode 15 is used instead of mode 14 with ICR1 as TOP, since ICR1 is not double buffered.
+ * OCR1A and OCR1B are both double buffered and updated at TOP, so new values are applied glitch free at end of period.
+ */
+void initTimer1ForPulse(void) {
+    DDRB |= _BV(DDB2); // set pin OC1B = PortB2 -> PIN 10 to output direction
+
+    TIMSK1 = 0; // no interrupts
+
+    TCCR1A = _BV(COM1B1) | _BV(WGM11) | _BV(WGM10); // Clear OC1B on compare match, set at BOTTOM
+    TCCR1B = _BV(WGM13) | _BV(WGM12); // Waveform Generation Mode 15 - Fast PWM with OCR1A as TOP - no clock->timer disabled
+    TCNT1 = 0; // init counter
+}
+
+/*
+ * 10-bit Fast PWM output at PIN 10 without interrupt - OCR1B is double buffered, so new values are applied glitch free
+ */
+void initTimer1ForDC(void) {
+    DDRB |= _BV(DDB2); // set pin OC1B = PortB2 -> PIN 10 to output direction
+
+    TIMSK1 = 0; // no interrupts
+
+    TCCR1A = _BV(COM1B1) | _BV(WGM11) | _BV(WGM10); // Clear OC1B on compare match, set at BOTTOM
+    TCCR1B = _BV(WGM12); // Waveform Generation Mode 7 - Fast PWM, 10-bit - no clock->timer disabled
+    OCR1B = 0; // output DC - LOW until first control step
+    TCNT1 = 0; // init counter
+}
+
+/*
+ * CTC output at PIN 10 - OCR1A determines the chip period
+ * Compare match B at BOTTOM sets or clears the output according to the compare output mode prepared by the ISR.
+ */
+void initTimer1ForPRBS(void) {
+    DDRB |= _BV(DDB2); // set pin OC1B = PortB2 -> PIN 10 to output direction
+
+    TCCR1A = _BV(COM1B1); // Clear OC1B on compare match / CTC mode
+    TCCR1B = _BV(WGM12); // CTC with OCR1A - no clock->timer disabled
+    OCR1B = 0;
+    TCNT1 = 0; // init counter
+    TIMSK1 = _BV(OCIE1B); // Enable compare B interrupt
+}
+
 void setWaveformMode(uint8_t aNewMode) {
-    aNewMode &= WAVEFORM_MASK;
+    if (aNewMode > WAVEFORM_MAX) {
+        aNewMode = WAVEFORM_SQUARE;
+    }
     sFrequencyInfo.Waveform = aNewMode;
     if (aNewMode == WAVEFORM_SQUARE) {
         initTimer1ForCTC();
+    } else if (aNewMode == WAVEFORM_PULSE) {
+        initTimer1ForPulse();
+    } else if (aNewMode == WAVEFORM_PRBS) {
+        initTimer1ForPRBS();
+    } else if (aNewMode == WAVEFORM_DC) {
+        initTimer1ForDC();
     } else {
-        initTimer1For8BitPWM();
+        initTimer1ForPWM();
     }
     // start timer if not already done
     startWaveform();
@@ -113,6 +209,36 @@ void cycleWaveformMode() {
     setWaveformMode(sFrequencyInfo.Waveform + 1);
 }
 
+/*
+ * Is taken for the next start of sine, triangle, sawtooth and noise and applied directly, if one of them is active
+ */
+void setPWMResolutionShift(uint8_t aPWMResolutionShift) {
+    if (aPWMResolutionShift > PWM_RESOLUTION_SHIFT_MAX) {
+        aPWMResolutionShift = PWM_RESOLUTION_SHIFT_8_BIT;
+    }
+    sFrequencyInfo.PWMResolutionShift = aPWMResolutionShift;
+    if (isPWMWaveform()) {
+        setWaveformMode(sFrequencyInfo.Waveform);
+    }
+}
+
+void cyclePWMResolution() {
+    setPWMResolutionShift(sFrequencyInfo.PWMResolutionShift + 1);
+}
+
+uint8_t getPWMResolutionBits() {
+    return 8 + sFrequencyInfo.PWMResolutionShift;
+}
+
+/*
+ * Returns true for the waveforms generated by the overflow ISR, which support different PWM resolutions
+ */
+bool isPWMWaveform() {
+    uint8_t tWaveform = sFrequencyInfo.Waveform;
+    return (tWaveform != WAVEFORM_SQUARE && tWaveform != WAVEFORM_PULSE && tWaveform != WAVEFORM_PRBS
+            && tWaveform != WAVEFORM_DC);
+}
+
 const char * cycleWaveformModePGMString() {
     cycleWaveformMode();
     return getWaveformModePGMString();
@@ -127,6 +253,14 @@ const char * getWaveformModePGMString() {
         tResultString = PSTR("Triangle");
     } else if (sFrequencyInfo.Waveform == WAVEFORM_SAWTOOTH) {
         tResultString = PSTR("Sawtooth");
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_PULSE) {
+        tResultString = PSTR("Pulse");
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_PRBS) {
+        tResultString = PSTR("PRBS");
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_NOISE) {
+        tResultString = PSTR("Noise");
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_DC) {
+        tResultString = PSTR("DC");
     }
     return tResultString;
 }
@@ -138,6 +272,9 @@ float getPeriodMicros() {
         // use better resolution here
         tPeriodMicros = sFrequencyInfo.ControlValue.DividerInt;
         tPeriodMicros /= 8;
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_PULSE || sFrequencyInfo.Waveform == WAVEFORM_PRBS) {
+        tPeriodMicros = sFrequencyInfo.ControlValue.DividerInt;
+        tPeriodMicros /= clockCyclesPerMicrosecond();
     } else {
         tPeriodMicros = sFrequencyInfo.PeriodMicros;
     }
@@ -193,6 +330,7 @@ bool setWaveformFrequency() {
  * SINE: clip to minimum 8 samples per period => 128 us / 7812.5 Hz
  * SAWTOOTH: clip to minimum 16 samples per period => 256 us / 3906.25 Hz
  * Triangle: clip to minimum 32 samples per period => 512 us / 1953.125 Hz
+ * Values are for 8 bit PWM, see table at top of file for 9 and 10 bit.
  * return true if clipping occurs
  */
 bool setWaveformFrequency(float aFrequency) {
@@ -200,24 +338,44 @@ bool setWaveformFrequency(float aFrequency) {
     if (sFrequencyInfo.Waveform == WAVEFORM_SQUARE) {
         // need initialized sFrequencyInfo structure
         hasError = setSquareWaveFrequency(aFrequency);
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_PULSE) {
+        hasError = setPulseFrequency(aFrequency);
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_PRBS) {
+        hasError = setPRBSChipRate(aFrequency);
+    } else if (sFrequencyInfo.Waveform == WAVEFORM_DC) {
+        // frequency is not used, keep it for the next waveform and only start Timer1
+        sFrequencyInfo.PrescalerRegisterValueBackup = 1;
+        if (sFrequencyInfo.isOutputEnabled) {
+            TCCR1B &= ~TIMER_PRESCALER_MASK;
+            TCCR1B |= _BV(CS10); // set prescaler to 1 -> gives 64 us / 15.625 kHz PWM
+        }
     } else {
-        // use shift 16 to increase resolution but avoid truncation
-        long tBasePeriodShift16 = (BASE_PERIOD_MICROS_FOR_SINE_TABLE << 16);
+        uint8_t tPWMResolutionShift = sFrequencyInfo.PWMResolutionShift;
+        uint32_t tBasePeriodMicros = (BASE_PERIOD_MICROS_FOR_SINE_TABLE << tPWMResolutionShift);
         if (sFrequencyInfo.Waveform == WAVEFORM_TRIANGLE) {
-            tBasePeriodShift16 = (BASE_PERIOD_MICROS_FOR_TRIANGLE << 16);
+            // (PWMTop + 1) + PWMTop values with 1/16 us * (PWMTop + 1) each -> 8176 us / 122.3092 Hz for 8 bit
+            uint32_t tPWMValues = (0x100 << tPWMResolutionShift);
+            tBasePeriodMicros = ((2 * tPWMValues - 1) * tPWMValues) / clockCyclesPerMicrosecond();
         } else if (sFrequencyInfo.Waveform == WAVEFORM_SAWTOOTH) {
-            tBasePeriodShift16 = (BASE_PERIOD_MICROS_FOR_SAWTOOTH << 16);
+            tBasePeriodMicros = (BASE_PERIOD_MICROS_FOR_SAWTOOTH << (2 * tPWMResolutionShift));
+        }
+        // Noise takes a new value at most every PWM cycle
+        uint32_t tBaseFrequencyFactorShift16Max = (16L << 16);
+        if (sFrequencyInfo.Waveform == WAVEFORM_NOISE) {
+            tBasePeriodMicros = (BASE_PERIOD_MICROS_FOR_NOISE << tPWMResolutionShift);
+            tBaseFrequencyFactorShift16Max = (1L << 16);
         }
         uint32_t tPeriodMicros = 1000000UL / aFrequency;
-        uint32_t tBaseFrequencyFactorShift16 = tBasePeriodShift16 / tPeriodMicros;
-        if (tBaseFrequencyFactorShift16 > (16L << 16)) {
+        // use shift 16 to increase resolution but avoid truncation. Float, since (tBasePeriodMicros << 16) overflows for 10 bit.
+        uint32_t tBaseFrequencyFactorShift16 = (tBasePeriodMicros * 65536.0) / tPeriodMicros;
+        if (tBaseFrequencyFactorShift16 > tBaseFrequencyFactorShift16Max) {
             // Clip at factor 16 (taking every 16th value) and recompute values
-            tBaseFrequencyFactorShift16 = (16L << 16);
-            tPeriodMicros = (tBasePeriodShift16 >> 16) / 16;
+            tBaseFrequencyFactorShift16 = tBaseFrequencyFactorShift16Max;
+            tPeriodMicros = tBasePeriodMicros / (tBaseFrequencyFactorShift16Max >> 16);
             hasError = true;
         } else if (tBaseFrequencyFactorShift16 < 1) {
             tBaseFrequencyFactorShift16 = 1;
-            tPeriodMicros = tBasePeriodShift16;
+            tPeriodMicros = (tBasePeriodMicros < 0x10000) ? (tBasePeriodMicros << 16) : 0xFFFFFFFF;
             hasError = true;
         }
         // recompute values
@@ -236,32 +394,13 @@ bool setWaveformFrequency(float aFrequency) {
     return hasError;
 }
 
-bool setSquareWaveFrequency(float aFrequency) {
-    bool hasError = false;
-    float tFrequency = aFrequency;
-    /*
-     * Timer runs in toggle mode and has 8 MHz / 0.125 us maximum frequency
-     * Divider = (F_CPU/2) / sFrequency
-     * Divider= 1, prescaler= 1 => 8 MHz
-     * Divider= 16348 * prescaler= 1024 = 0x200000000 => 8,388,608 us => 0.119209 Hz
-     */
-    uint32_t tDividerInteger = (F_CPU / 2) / tFrequency;
-    if (tDividerInteger == 0) {
-        if (tFrequency < 1) {
-            // for very small frequencies (F_CPU / 2) / tFrequency gives NaN which results in 0
-            tDividerInteger = 0x10000 * 1024; // maximum divider
-        } else {
-            // 8 MHz / 0.125 us is maximum
-            hasError = true;
-            tDividerInteger = 1;
-            tFrequency = 8;
-        }
-    }
-
-    /*
-     * Determine prescaler and PrescalerRegisterValue from tDividerInteger value,
-     * in order to get an tDividerInteger value <= 0x10000 (register value is tDividerInteger-1)
-     */
+/*
+ * Determine prescaler and PrescalerRegisterValue from aDividerInteger value,
+ * in order to get an aDividerInteger value <= 0x10000 (register value is aDividerInteger-1)
+ * Returns PrescalerRegisterValue and sets aDividerInteger to the divider for this prescaler
+ */
+uint8_t computeTimer1Prescaler(uint32_t * aDividerInteger, uint16_t * aPrescaler) {
+    uint32_t tDividerInteger = *aDividerInteger;
     uint16_t tPrescaler = 1; // direct clock
     uint8_t tPrescalerRegisterValue = 1;
     if (tDividerInteger > 0x10000) {
@@ -291,6 +430,35 @@ bool setSquareWaveFrequency(float aFrequency) {
             }
         }
     }
+    *aDividerInteger = tDividerInteger;
+    *aPrescaler = tPrescaler;
+    return tPrescalerRegisterValue;
+}
+
+bool setSquareWaveFrequency(float aFrequency) {
+    bool hasError = false;
+    float tFrequency = aFrequency;
+    /*
+     * Timer runs in toggle mode and has 8 MHz / 0.125 us maximum frequency
+     * Divider = (F_CPU/2) / sFrequency
+     * Divider= 1, prescaler= 1 => 8 MHz
+     * Divider= 16348 * prescaler= 1024 = 0x200000000 => 8,388,608 us => 0.119209 Hz
+     */
+    uint32_t tDividerInteger = (F_CPU / 2) / tFrequency;
+    if (tDividerInteger == 0) {
+        if (tFrequency < 1) {
+            // for very small frequencies (F_CPU / 2) / tFrequency gives NaN which results in 0
+            tDividerInteger = 0x10000 * 1024; // maximum divider
+        } else {
+            // 8 MHz / 0.125 us is maximum
+            hasError = true;
+            tDividerInteger = 1;
+            tFrequency = 8;
+        }
+    }
+
+    uint16_t tPrescaler;
+    uint8_t tPrescalerRegisterValue = computeTimer1Prescaler(&tDividerInteger, &tPrescaler);
     sFrequencyInfo.PrescalerRegisterValueBackup = tPrescalerRegisterValue;
     if (sFrequencyInfo.isOutputEnabled) {
         // set values to timer register
@@ -315,6 +483,142 @@ bool setSquareWaveFrequency(float aFrequency) {
     return hasError;
 }
 
+/*
+ * Period and pulse width are computed with integer math from CPU clocks.
+ * Pulse width is clipped to at least one timer tick and at most one tick less than period.
+ * Period is clipped to 2 clocks / 8 MHz and 0x10000 * 1024 clocks / 0.238 Hz
+ * return true if clipping occurs
+ */
+bool setPulseFrequency(float aFrequency) {
+    bool hasError = false;
+    uint32_t tDividerInteger = F_CPU / aFrequency;
+    if (tDividerInteger < 2) {
+        if (aFrequency < 1) {
+            // for very small frequencies F_CPU / aFrequency gives NaN which results in 0
+            tDividerInteger = 0x10000 * 1024L; // maximum divider
+        } else {
+            hasError = true;
+            tDividerInteger = 2;
+        }
+    }
+
+    uint16_t tPrescaler;
+    uint8_t tPrescalerRegisterValue = computeTimer1Prescaler(&tDividerInteger, &tPrescaler);
+
+    // high time is OCR1B + 1 ticks
+    uint32_t tPulseWidthTicks = sFrequencyInfo.PulseWidthClocks / tPrescaler;
+    if (tPulseWidthTicks == 0) {
+        tPulseWidthTicks = 1;
+        hasError = true;
+    } else if (tPulseWidthTicks >= tDividerInteger) {
+        tPulseWidthTicks = tDividerInteger - 1;
+        hasError = true;
+    }
+
+    sFrequencyInfo.PrescalerRegisterValueBackup = tPrescalerRegisterValue;
+    if (sFrequencyInfo.isOutputEnabled && (TCCR1B & TIMER_PRESCALER_MASK) != tPrescalerRegisterValue) {
+        // changing prescaler while running cannot be synchronized to end of period
+        TCCR1B &= ~TIMER_PRESCALER_MASK;
+        TCCR1B |= tPrescalerRegisterValue;
+    }
+
+    /*
+     * The buffered values are taken at TOP. If this happens between the two writes, one period is generated
+     * with old period and new pulse width or vice versa. Choose order which keeps pulse width less than period for this one.
+     */
+    uint8_t tSREG = SREG;
+    cli();
+    if (tPulseWidthTicks > OCR1A) {
+        OCR1A = tDividerInteger - 1;
+        OCR1B = tPulseWidthTicks - 1;
+    } else {
+        OCR1B = tPulseWidthTicks - 1;
+        OCR1A = tDividerInteger - 1;
+    }
+    SREG = tSREG;
+
+    /*
+     * Save achieved values
+     */
+    tDividerInteger *= tPrescaler;
+    sFrequencyInfo.Frequency = ((float) F_CPU) / tDividerInteger;
+    sFrequencyInfo.ControlValue.DividerInt = tDividerInteger;
+    sFrequencyInfo.PeriodMicros = tDividerInteger / clockCyclesPerMicrosecond();
+    sFrequencyInfo.PulseWidthClocksEffective = tPulseWidthTicks * tPrescaler;
+    return hasError;
+}
+
+/*
+ * Sets pulse width for WAVEFORM_PULSE and recomputes timer values if pulse mode is active
+ * Pulse width is clipped to one CPU clock and to the maximum period of 0x10000 * 1024 clocks (4.19 s),
+ * since conversion of a negative or too big float to an unsigned value is undefined.
+ * return true if clipping occurs
+ */
+bool setPulseWidthMicros(float aPulseWidthMicros) {
+    bool hasError = false;
+    float tPulseWidthClocks = aPulseWidthMicros * clockCyclesPerMicrosecond();
+    if (!(tPulseWidthClocks >= 1)) {
+        // also for NaN
+        tPulseWidthClocks = 1;
+        hasError = true;
+    } else if (tPulseWidthClocks > (0x10000 * 1024L)) {
+        tPulseWidthClocks = 0x10000 * 1024L;
+        hasError = true;
+    }
+    sFrequencyInfo.PulseWidthClocks = tPulseWidthClocks;
+    if (sFrequencyInfo.Waveform == WAVEFORM_PULSE) {
+        hasError |= setWaveformFrequency();
+    }
+    return hasError;
+}
+
+/*
+ * Chip rate is clipped to PRBS_CHIP_RATE_MAX_HZ, since every chip requires an interrupt
+ * return true if clipping occurs
+ */
+bool setPRBSChipRate(float aChipRate) {
+    bool hasError = false;
+    if (aChipRate > PRBS_CHIP_RATE_MAX_HZ) {
+        aChipRate = PRBS_CHIP_RATE_MAX_HZ;
+        hasError = true;
+    }
+    uint32_t tDividerInteger = F_CPU / aChipRate;
+    if (tDividerInteger == 0) {
+        // for very small frequencies F_CPU / aChipRate gives NaN which results in 0
+        tDividerInteger = 0x10000 * 1024L; // maximum divider
+    }
+
+    uint16_t tPrescaler;
+    uint8_t tPrescalerRegisterValue = computeTimer1Prescaler(&tDividerInteger, &tPrescaler);
+    sFrequencyInfo.PrescalerRegisterValueBackup = tPrescalerRegisterValue;
+    if (sFrequencyInfo.isOutputEnabled) {
+        TCCR1B &= ~TIMER_PRESCALER_MASK;
+        TCCR1B |= tPrescalerRegisterValue;
+    }
+    OCR1A = tDividerInteger - 1; // set compare match register
+
+    /*
+     * Save achieved values
+     */
+    tDividerInteger *= tPrescaler;
+    sFrequencyInfo.Frequency = ((float) F_CPU) / tDividerInteger;
+    sFrequencyInfo.ControlValue.DividerInt = tDividerInteger;
+    sFrequencyInfo.PeriodMicros = tDividerInteger / clockCyclesPerMicrosecond();
+    return hasError;
+}
+
+float getPulseWidthMicros() {
+    float tPulseWidthMicros = sFrequencyInfo.PulseWidthClocksEffective;
+    return tPulseWidthMicros / clockCyclesPerMicrosecond();
+}
+
+/*
+ * Only for WAVEFORM_DC. 0 to DC_PWM_TOP
+ */
+void setDCPWMValue(uint16_t aPWMValue) {
+    OCR1B = aPWMValue;
+}
+
 void stopWaveform() {
 // set prescaler choice to 0 -> timer stops
     TCCR1B &= ~TIMER_PRESCALER_MASK;
@@ -330,10 +634,18 @@ ISR(TIMER1_OVF_vect) {
 
     static int8_t sSineTableIndex = 0;
     static uint8_t sNumberOfQuadrant = 0;
-    static uint8_t sNextOcrbValue = 0;
+    static uint16_t sNextOcrbValue = 0;
 
 // output value at start of ISR to avoid jitter
     OCR1B = sNextOcrbValue;
+#ifdef MEASURE_ISR_TIMING
+    uint8_t tTimer2TicksAtStart = TCNT2;
+    uint16_t tLatencyCycles = ISR_TIMING_NO_LATENCY;
+    if ((TCCR1B & TIMER_PRESCALER_MASK) == _BV(CS10)) {
+        // timer1 counts CPU cycles since overflow modulo PWMTop + 1, minus the few cycles for setting OCR1B
+        tLatencyCycles = TCNT1;
+    }
+#endif
     /*
      * Increase index by sBaseFrequencyFactor.
      * In order to avoid floating point arithmetic in ISR, use sBaseFrequencyFactorShift16 and handle resulting residual.
@@ -350,6 +662,7 @@ ISR(TIMER1_OVF_vect) {
     }
     if (tIndexDelta > 0) {
         uint8_t tNumberOfQuadrant = sNumberOfQuadrant;
+        uint16_t tPWMTop = sFrequencyInfo.PWMTop;
         if (sFrequencyInfo.Waveform == WAVEFORM_SINE) {
             uint8_t tQuadrantIncrease = 0;
             switch (tNumberOfQuadrant) {
@@ -370,11 +683,20 @@ ISR(TIMER1_OVF_vect) {
                 }
                 break;
             }
+            uint16_t tSineValue;
+            if (tPWMTop == 0xFF) {
+                tSineValue = pgm_read_byte(&sSineTableQuarter128[sSineTableIndex]);
+            } else {
+                tSineValue = pgm_read_word(&sSineTableQuarter512[sSineTableIndex]);
+                if (tPWMTop == 0x1FF) {
+                    tSineValue >>= 1;
+                }
+            }
             if (tNumberOfQuadrant & 0x02) {
-                // case 2 and 3   -128 -> 128 ; -255 -> 1
-                sNextOcrbValue = -(pgm_read_byte(&sSineTableQuarter128[sSineTableIndex]));
+                // case 2 and 3   -128 -> 128 ; -255 -> 1 for 8 bit
+                sNextOcrbValue = (tPWMTop + 1) - tSineValue;
             } else {
-                sNextOcrbValue = pgm_read_byte(&sSineTableQuarter128[sSineTableIndex]);
+                sNextOcrbValue = tSineValue;
             }
 
             tNumberOfQuadrant = (tNumberOfQuadrant + tQuadrantIncrease) & 0x03;
@@ -404,37 +726,71 @@ ISR(TIMER1_OVF_vect) {
             //    }
         } else if (sFrequencyInfo.Waveform == WAVEFORM_TRIANGLE) {
             /*
-             * Values 0 and FF are half as often as other values, so special treatment required
-             * One period from 0 to 0 consists of 256 + 255 values!
+             * Values 0 and PWMTop are half as often as other values, so special treatment required
+             * One period from 0 to 0 consists of 256 + 255 values for 8 bit!
              */
-            uint8_t tOldOcrbValue = sNextOcrbValue;
+            int16_t tValue = sNextOcrbValue & tPWMTop; // mask value of higher resolution after switching
             if (tNumberOfQuadrant == 0) {
-                // Value from 1 to FF
+                // Value from 1 to PWMTop
                 // increasing value
-                sNextOcrbValue += tIndexDelta;
-                // detect overflow (value > 0xFF)
-                if (sNextOcrbValue < tOldOcrbValue) {
+                tValue += tIndexDelta;
+                // detect overflow (value > PWMTop)
+                if (tValue > (int16_t) tPWMTop) {
                     tNumberOfQuadrant = 1;
-                    // 0->FE, 1->FD
-                    sNextOcrbValue = (~sNextOcrbValue) - 1;
+                    // PWMTop+1 -> PWMTop-1, PWMTop+2 -> PWMTop-2
+                    tValue = (2 * tPWMTop) - tValue;
                 }
             } else {
-                // decreasing value Value from FE to 0
-                sNextOcrbValue -= tIndexDelta;
+                // decreasing value Value from PWMTop-1 to 0
+                tValue -= tIndexDelta;
                 // detect underflow
-                if (sNextOcrbValue > tOldOcrbValue) {
+                if (tValue < 0) {
                     tNumberOfQuadrant = 0;
-                    // FF -> 1, FE -> 2
-                    sNextOcrbValue = -sNextOcrbValue;
+                    // -1 -> 1, -2 -> 2
+                    tValue = -tValue;
                 }
             }
+            sNextOcrbValue = tValue;
 
         } else if (sFrequencyInfo.Waveform == WAVEFORM_SAWTOOTH) {
-            sNextOcrbValue += tIndexDelta;
+            sNextOcrbValue = (sNextOcrbValue + tIndexDelta) & tPWMTop;
+        } else if (sFrequencyInfo.Waveform == WAVEFORM_NOISE) {
+            /*
+             * 8 to 10 shifts for a new value, otherwise consecutive values are correlated. Takes around 70 cycles for 8 bit.
+             */
+            uint16_t tLFSRValue = sLFSRValue;
+            for (uint8_t i = 0; i < 8 + sFrequencyInfo.PWMResolutionShift; ++i) {
+                if (tLFSRValue & 0x01) {
+                    tLFSRValue = (tLFSRValue >> 1) ^ LFSR_TAPS;
+                } else {
+                    tLFSRValue >>= 1;
+                }
+            }
+            sLFSRValue = tLFSRValue;
+            sNextOcrbValue = tLFSRValue & tPWMTop;
         }
         sNumberOfQuadrant = tNumberOfQuadrant;
 
     }
+#ifdef MEASURE_ISR_TIMING
+    addISRTiming(ISR_TIMING_TIMER1_OVF, tTimer2TicksAtStart, tLatencyCycles);
+#endif
+}
+
+/*
+ * Timer1 compare B interrupt vector handler for PRBS
+ * Current chip was just output by hardware, so prepare compare output mode for next chip - set or clear OC1B on compare match.
+ */
+ISR(TIMER1_COMPB_vect) {
+    uint16_t tLFSRValue = sLFSRValue;
+    if (tLFSRValue & 0x01) {
+        TCCR1A = _BV(COM1B1) | _BV(COM1B0); // Set OC1B on compare match / CTC mode
+        tLFSRValue = (tLFSRValue >> 1) ^ LFSR_TAPS;
+    } else {
+        TCCR1A = _BV(COM1B1); // Clear OC1B on compare match / CTC mode
+        tLFSRValue >>= 1;
+    }
+    sLFSRValue = tLFSRValue;
 }
 
 /*
@@ -14,8 +14,24 @@
 #define WAVEFORM_SINE 1
 #define WAVEFORM_TRIANGLE 2
 #define WAVEFORM_SAWTOOTH 3
-#define WAVEFORM_MAX WAVEFORM_MODE_SAWTOOTH
-#define WAVEFORM_MASK 0x03
+#define WAVEFORM_PULSE 4
+#define WAVEFORM_PRBS 5  // maximal length LFSR bit sequence with chip rate as frequency
+#define WAVEFORM_NOISE 6 // LFSR values masked with PWMTop (8, 9 or 10 bit) as PWM, frequency is the rate of new values
+#define WAVEFORM_DC 7    // 10 bit PWM with constant value, set by closed loop control in FrequencyGeneratorPage.cpp
+#define WAVEFORM_MAX WAVEFORM_DC
+
+#define DC_PWM_TOP 0x3FF // 10 bit PWM at 15.625 kHz
+
+#define PULSE_WIDTH_MICROS_DEFAULT 100
+
+/*
+ * PWM resolution for sine, triangle, sawtooth and noise.
+ * Each additional bit halves the PWM frequency and therefore the maximum waveform frequency, see Waveforms.cpp.
+ */
+#define PWM_RESOLUTION_SHIFT_8_BIT 0  // 62.5 kHz PWM
+#define PWM_RESOLUTION_SHIFT_9_BIT 1  // 31.25 kHz PWM
+#define PWM_RESOLUTION_SHIFT_10_BIT 2 // 15.625 kHz PWM
+#define PWM_RESOLUTION_SHIFT_MAX PWM_RESOLUTION_SHIFT_10_BIT
 
 #define FREQUENCY_FACTOR_INDEX_MILLI_HERTZ 0
 #define FREQUENCY_FACTOR_INDEX_HERTZ 1
@@ -24,7 +40,7 @@
 
 struct FrequencyInfoStruct {
     union {
-        uint32_t DividerInt; // Only for square wave and for info - may be (divider * prescaler) - resolution is 1/8 us
+        uint32_t DividerInt; // Only for square, pulse and PRBS wave and for info - may be (divider * prescaler) - resolution is 1/8 us, for pulse and PRBS 1/16 us
         uint32_t BaseFrequencyFactorShift16; // Value used by ISR - only for NON square wave
     } ControlValue;
     uint32_t PeriodMicros; // only for display purposes
@@ -32,6 +48,8 @@ struct FrequencyInfoStruct {
 
     uint8_t Waveform;  // 0 to WAVEFORM_MAX
     bool isOutputEnabled;
+    uint8_t PWMResolutionShift; // number of PWM bits above 8 - PWM_RESOLUTION_SHIFT_*
+    uint16_t PWMTop; // 0xFF, 0x1FF or 0x3FF. Value used by ISR - set by initTimer1ForPWM()
 
     /*
      * Normalized frequency variables for display
@@ -45,6 +63,9 @@ struct FrequencyInfoStruct {
      */
     int32_t BaseFrequencyFactorAccumulator; //  Value used by ISR - used to handle fractions of BaseFrequencyFactorShift16
 
+    uint32_t PulseWidthClocks; // requested pulse width for WAVEFORM_PULSE in CPU clocks
+    uint32_t PulseWidthClocksEffective; // achieved pulse width, depends on prescaler of period
+
     uint8_t PrescalerRegisterValueBackup; // backup of old value for start/stop of square wave
 };
 extern struct FrequencyInfoStruct sFrequencyInfo;
@@ -60,10 +81,19 @@ float getPeriodMicros();
 void setNormalizedFrequencyAndFactor(float aValue);
 void setNormalizedFrequencyFactor(int aIndexValue);
 
-void initTimer1For8BitPWM();
+void initTimer1ForPWM();
+void setPWMResolutionShift(uint8_t aPWMResolutionShift);
+void cyclePWMResolution();
+uint8_t getPWMResolutionBits();
+bool isPWMWaveform();
 bool setWaveformFrequency();
 bool setWaveformFrequency(float aFrequency);
 bool setSquareWaveFrequency(float aFrequency);
+bool setPulseFrequency(float aFrequency);
+bool setPulseWidthMicros(float aPulseWidthMicros);
+bool setPRBSChipRate(float aChipRate);
+float getPulseWidthMicros();
+void setDCPWMValue(uint16_t aPWMValue);
 
 void stopWaveform();
 void startWaveform();
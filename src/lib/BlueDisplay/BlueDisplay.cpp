@@ -48,6 +48,9 @@ BlueDisplay::BlueDisplay(void) { // @suppress("Class members should be properly
     mReferenceDisplaySize.XWidth = DISPLAY_DEFAULT_WIDTH;
     mReferenceDisplaySize.YHeight = DISPLAY_DEFAULT_HEIGHT;
     mConnectionEstablished = false;
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+    mNumberOfPaletteColors = 0;
+#endif
 }
 
 // One instance of BlueDisplay called BlueDisplay1
@@ -139,6 +142,10 @@ void BlueDisplay::setFlagsAndSize(uint16_t aFlags, uint16_t aWidth, uint16_t aHe
             // reset local buttons to be synchronized
             BDButton::resetAllButtons();
             BDSlider::resetAllSliders();
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+            // palette of app is also reset
+            mNumberOfPaletteColors = 0;
+#endif
         }
         sendUSARTArgs(FUNCTION_GLOBAL_SETTINGS, 4, SUBFUNCTION_GLOBAL_SET_FLAGS_AND_SIZE, aFlags, aWidth, aHeight);
     }
@@ -243,6 +250,59 @@ void BlueDisplay::drawDisplayDirect(void) {
     }
 }
 
+/**
+ * All following draw functions draw to this layer. 0 is the normal canvas.
+ */
+void BlueDisplay::setDrawLayer(uint8_t aLayerIndex) {
+    if (USART_isBluetoothPaired()) {
+        sendUSARTArgs(FUNCTION_LAYER_SETTINGS, 2, SUBFUNCTION_LAYER_SET_DRAW_LAYER, aLayerIndex);
+    }
+}
+
+/**
+ * Makes all pixels of layer transparent
+ */
+void BlueDisplay::clearLayer(uint8_t aLayerIndex) {
+    if (USART_isBluetoothPaired()) {
+        sendUSARTArgs(FUNCTION_LAYER_SETTINGS, 2, SUBFUNCTION_LAYER_CLEAR, aLayerIndex);
+    }
+}
+
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+/**
+ * Colors of palette can be sent as index by compact draw functions.
+ * Palette is reset by setFlagsAndSize() with BD_FLAG_FIRST_RESET_ALL, so set it after this call.
+ */
+void BlueDisplay::setPaletteColor(uint8_t aPaletteIndex, color16_t aColor) {
+    if (aPaletteIndex < BD_PALETTE_SIZE) {
+        mPaletteColors[aPaletteIndex] = aColor;
+        if (mNumberOfPaletteColors <= aPaletteIndex) {
+            mNumberOfPaletteColors = aPaletteIndex + 1;
+        }
+        if (USART_isBluetoothPaired()) {
+            sendUSARTArgs(FUNCTION_GLOBAL_SETTINGS, 3, SUBFUNCTION_GLOBAL_SET_PALETTE_COLOR, aPaletteIndex, aColor);
+        }
+    }
+}
+
+/**
+ * Sends line with 3 instead of 5 parameters, if X fits in 9 bit, Y in 8 bit and color is in palette
+ * @return false if line was not sent
+ */
+bool BlueDisplay::sendLineCompact(uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd, uint16_t aYEnd, color16_t aColor) {
+    if ((aXStart | aXEnd) >= 0x200 || (aYStart | aYEnd) >= 0x100) {
+        return false;
+    }
+    for (uint8_t i = 0; i < mNumberOfPaletteColors; ++i) {
+        if (mPaletteColors[i] == aColor) {
+            sendUSARTArgs(FUNCTION_DRAW_LINE_COMPACT, 3, aXStart | (i << 9), aXEnd, aYStart | (aYEnd << 8));
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
 void BlueDisplay::drawPixel(uint16_t aXPos, uint16_t aYPos, color16_t aColor) {
 #ifdef LOCAL_DISPLAY_EXISTS
     LocalDisplay.drawPixel(aXPos, aYPos, aColor);
@@ -257,6 +317,11 @@ void BlueDisplay::drawLine(uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd, u
     LocalDisplay.drawLine(aXStart, aYStart, aXEnd, aYEnd, aColor);
 #endif
     if (USART_isBluetoothPaired()) {
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+        if (sendLineCompact(aXStart, aYStart, aXEnd, aYEnd, aColor)) {
+            return;
+        }
+#endif
         sendUSART5Args(FUNCTION_DRAW_LINE, aXStart, aYStart, aXEnd, aYEnd, aColor);
     }
 }
@@ -266,6 +331,13 @@ void BlueDisplay::drawLineRel(uint16_t aXStart, uint16_t aYStart, uint16_t aXDel
     LocalDisplay.drawLine(aXStart, aYStart, aXStart + aXDelta, aYStart + aYDelta, aColor);
 #endif
     if (USART_isBluetoothPaired()) {
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+        // Negative deltas are two's complement and wrap around to the right end value, so they are sent compact as well.
+        // Only an end outside of X 0 to 0x1FF or Y 0 to 0xFF, i.e. beyond the left or top border, is sent as regular line.
+        if (sendLineCompact(aXStart, aYStart, aXStart + aXDelta, aYStart + aYDelta, aColor)) {
+            return;
+        }
+#endif
         sendUSART5Args(FUNCTION_DRAW_LINE_REL, aXStart, aYStart, aXDelta, aYDelta, aColor);
     }
 }
@@ -282,6 +354,11 @@ void BlueDisplay::drawLineFastOneX(uint16_t aXStart, uint16_t aYStart, uint16_t
 #endif
     if (USART_isBluetoothPaired()) {
         // Just draw plain line, no need to speed up
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+        if (sendLineCompact(aXStart, aYStart, aXStart + 1, aYEnd, aColor)) {
+            return;
+        }
+#endif
         sendUSART5Args(FUNCTION_DRAW_LINE, aXStart, aYStart, aXStart + 1, aYEnd, aColor);
     }
 }
@@ -565,6 +642,15 @@ void BlueDisplay::writeString(const char *aStringPtr, uint8_t aStringLength) {
     }
 }
 
+/**
+ * Send binary data e.g. of a data logger to host. Record type and number are for host side parsing and loss detection.
+ */
+void BlueDisplay::writeDataRecord(uint8_t aRecordType, uint16_t aRecordNumber, uint8_t *aByteBuffer, size_t aByteBufferLength) {
+    if (USART_isBluetoothPaired()) {
+        sendUSARTArgsAndByteBuffer(FUNCTION_WRITE_DATA_RECORD, 2, aRecordType, aRecordNumber, aByteBufferLength, aByteBuffer);
+    }
+}
+
 // for use in syscalls.c
 extern "C" void writeStringC(const char *aStringPtr, uint8_t aStringLength) {
 #ifdef LOCAL_DISPLAY_EXISTS
@@ -810,6 +896,19 @@ void BlueDisplay::drawChartByteBuffer(uint16_t aXOffset, uint16_t aYOffset, colo
     }
 }
 
+/**
+ * if aClearBeforeColor != 0 then previous line is cleared before
+ * consecutive values are aXStep pixel apart and are connected by lines on the remote side,
+ * so only one value per aXStep pixel has to be sent
+ */
+void BlueDisplay::drawChartByteBufferWithXStep(uint16_t aXOffset, uint16_t aYOffset, uint8_t aXStep, color16_t aColor,
+        color16_t aClearBeforeColor, uint8_t *aByteBuffer, size_t aByteBufferLength) {
+    if (USART_isBluetoothPaired()) {
+        sendUSARTArgsAndByteBuffer(FUNCTION_DRAW_CHART_WITH_X_STEP, 5, aXOffset, aYOffset, aColor, aClearBeforeColor, aXStep,
+                aByteBufferLength, aByteBuffer);
+    }
+}
+
 struct XYSize * BlueDisplay::getMaxDisplaySize(void) {
     return &mMaxDisplaySize;
 }
@@ -106,6 +106,14 @@
  * Version 3.0 Android sensor accessible by Arduino.
  */
 
+/*
+ * Activate this, if your BlueDisplay app supports FUNCTION_DRAW_LINE_COMPACT.
+ * Then lines with X < 512 and Y < 256 and a color set by setPaletteColor() are sent with 10 instead of 14 bytes,
+ * i.e. about 29 % less. Only lines have a compact variant, all other draw functions are sent as before.
+ */
+//#define SUPPORT_COMPACT_DRAW_FUNCTIONS
+#define BD_PALETTE_SIZE 8
+
 /***************************
  * Origin 0.0 is upper left
  **************************/
@@ -347,8 +355,14 @@ public:
 
     void clearDisplay(color16_t aColor = COLOR_WHITE);
     void drawDisplayDirect(void);
+    void setDrawLayer(uint8_t aLayerIndex);
+    void clearLayer(uint8_t aLayerIndex);
     void setScreenOrientationLock(uint8_t aLockMode);
 
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+    void setPaletteColor(uint8_t aPaletteIndex, color16_t aColor);
+    bool sendLineCompact(uint16_t aXStart, uint16_t aYStart, uint16_t aXEnd, uint16_t aYEnd, color16_t aColor);
+#endif
     void drawPixel(uint16_t aXPos, uint16_t aYPos, color16_t aColor);
     void drawCircle(uint16_t aXCenter, uint16_t aYCenter, uint16_t aRadius, color16_t aColor, uint16_t aStrokeWidth);
     void fillCircle(uint16_t aXCenter, uint16_t aYCenter, uint16_t aRadius, color16_t aColor);
@@ -376,6 +390,7 @@ public:
     void setPrintfPosition(uint16_t aPosX, uint16_t aPosY);
     void setPrintfPositionColumnLine(uint16_t aColumnNumber, uint16_t aLineNumber);
     void writeString(const char *aStringPtr, uint8_t aStringLength);
+    void writeDataRecord(uint8_t aRecordType, uint16_t aRecordNumber, uint8_t *aByteBuffer, size_t aByteBufferLength);
 
     void debugMessage(const char *aStringPtr);
     void debug(const char *aStringPtr);
@@ -411,6 +426,8 @@ public:
             uint8_t *aByteBuffer, size_t aByteBufferLength);
     void drawChartByteBuffer(uint16_t aXOffset, uint16_t aYOffset, color16_t aColor, color16_t aClearBeforeColor,
             uint8_t aChartIndex, bool aDoDrawDirect, uint8_t *aByteBuffer, size_t aByteBufferLength);
+    void drawChartByteBufferWithXStep(uint16_t aXOffset, uint16_t aYOffset, uint8_t aXStep, color16_t aColor,
+            color16_t aClearBeforeColor, uint8_t *aByteBuffer, size_t aByteBufferLength);
 
     struct XYSize * getMaxDisplaySize(void);
     uint16_t getMaxDisplayWidth(void);
@@ -519,6 +536,10 @@ public:
     struct XYSize mCurrentDisplaySize; // contains real host display size. Is initialized at connection build up and updated at reorientation and redraw event.
     struct XYSize mMaxDisplaySize; // contains max display size.  Is initialized at connection build up and updated at reorientation event.
     uint32_t mHostUnixTimestamp;
+#ifdef SUPPORT_COMPACT_DRAW_FUNCTIONS
+    color16_t mPaletteColors[BD_PALETTE_SIZE];
+    uint8_t mNumberOfPaletteColors;
+#endif
 
     volatile bool mConnectionEstablished;
     volatile bool mOrientationIsLandscape;
@@ -234,6 +234,7 @@ static const int FUNCTION_GLOBAL_SETTINGS = 0x08;
 static const int SUBFUNCTION_GLOBAL_SET_FLAGS_AND_SIZE = 0x00;
 static const int SUBFUNCTION_GLOBAL_SET_CODEPAGE = 0x01;
 static const int SUBFUNCTION_GLOBAL_SET_CHARACTER_CODE_MAPPING = 0x02;
+static const int SUBFUNCTION_GLOBAL_SET_PALETTE_COLOR = 0x03;
 static const int SUBFUNCTION_GLOBAL_SET_LONG_TOUCH_DOWN_TIMEOUT = 0x08;
 static const int SUBFUNCTION_GLOBAL_SET_SCREEN_ORIENTATION_LOCKATION_LOCK = 0x0C;
 
@@ -266,6 +267,16 @@ const int FUNCTION_NOP = 0x7F;
  *********************/
 const int FUNCTION_CLEAR_DISPLAY = 0x10;
 const int FUNCTION_DRAW_DISPLAY = 0x11;
+/*
+ * Layers. Layer 0 is the normal canvas, layer n + 1 is drawn below layer n.
+ * FUNCTION_CLEAR_DISPLAY clears all layers. Pixels with the color of the last FUNCTION_CLEAR_DISPLAY are transparent,
+ * so erasing a chart on layer 0 with the background color does not hide the layers below.
+ */
+const int FUNCTION_LAYER_SETTINGS = 0x12;
+// Sub functions for LAYER_SETTINGS
+const int SUBFUNCTION_LAYER_SET_DRAW_LAYER = 0x00; // all following draw functions draw to this layer
+const int SUBFUNCTION_LAYER_CLEAR = 0x01;
+// No sub function to show or hide a layer. A hidden layer had to be redrawn after each FUNCTION_CLEAR_DISPLAY anyway.
 // 3 parameter
 const int FUNCTION_DRAW_PIXEL = 0x14;
 // 6 parameter
@@ -273,6 +284,8 @@ const int FUNCTION_DRAW_CHAR = 0x16;
 // 5 parameter
 const int FUNCTION_DRAW_LINE_REL = 0x20;
 const int FUNCTION_DRAW_LINE = 0x21;
+// 3 parameter: XStart | (palette index << 9), XEnd, YStart | (YEnd << 8)
+const int FUNCTION_DRAW_LINE_COMPACT = 0x22;
 const int FUNCTION_DRAW_RECT_REL = 0x24;
 const int FUNCTION_FILL_RECT_REL = 0x25;
 const int FUNCTION_DRAW_RECT = 0x26;
@@ -295,6 +308,9 @@ const int INDEX_LAST_FUNCTION_WITHOUT_DATA = 0x5F;
 const int FUNCTION_DRAW_STRING = 0x60;
 const int FUNCTION_DEBUG_STRING = 0x61;
 const int FUNCTION_WRITE_STRING = 0x62;
+// 2 parameter: record type, record number. Data is the binary record, which is appended to the log of the host.
+// Record type and layout are defined by the application, e.g. DATA_LOGGER_RECORD_TYPE_MIN_AVERAGE_MAX of the DSO.
+const int FUNCTION_WRITE_DATA_RECORD = 0x63;
 
 const int FUNCTION_GET_NUMBER_WITH_SHORT_PROMPT = 0x64;
 const int FUNCTION_GET_TEXT_WITH_SHORT_PROMPT = 0x65;
@@ -303,6 +319,7 @@ const int FUNCTION_DRAW_PATH = 0x68;
 const int FUNCTION_FILL_PATH = 0x69;
 const int FUNCTION_DRAW_CHART = 0x6A;
 const int FUNCTION_DRAW_CHART_WITHOUT_DIRECT_RENDERING = 0x6B;
+const int FUNCTION_DRAW_CHART_WITH_X_STEP = 0x6C;
 
 /**********************
  * Button functions